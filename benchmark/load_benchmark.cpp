@@ -0,0 +1,68 @@
+#include "../src/particles.hpp"
+#include "../src/particles_exporter.hpp"
+#include "../src/particles_loader/csv.hpp"
+#include "../src/particles_loader/prof.hpp"
+#include "../src/particles_loader/vtu.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace fs     = std::filesystem;
+namespace chrono = std::chrono;
+using std::cout;
+using std::endl;
+
+/**
+ * @brief Benchmark of loading particles files
+ *
+ * @details Files of the given number of particles (10M by default) are written in each format into a temporary
+ * directory, and the time to load each of them is measured.
+ *
+ * Usage: `load_benchmark [number of particles]`
+ */
+int main(int argc, char** argv) {
+    int particleSize = (argc > 1) ? std::stoi(argv[1]) : 10000000;
+
+    Particles particles;
+    particles.reserve(particleSize);
+    for (int i = 0; i < particleSize; i++) {
+        Eigen::Vector3d pos(0.001 * (i % 1000), 0.001 * ((i / 1000) % 1000), 0.001 * (i / 1000000));
+        Eigen::Vector3d vel(1.0 / (i + 1), 0.5, -0.25);
+        particles.add(Particle(i, (i % 10 == 0) ? ParticleType::Wall : ParticleType::Fluid, pos, vel, 1000.0));
+    }
+
+    fs::path dir = fs::temp_directory_path() / "mps_load_benchmark";
+    fs::create_directories(dir);
+    ParticlesExporter exporter;
+    exporter.setParticles(particles);
+
+    // load the file and print the elapsed time, then remove the file
+    auto measure = [&](const std::string& name, const fs::path& path, ParticlesLoader::Interface& loader) {
+        auto begin                   = chrono::steady_clock::now();
+        auto [time, loadedParticles] = loader.load(path, 1000.0);
+        double seconds               = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        cout << name << ": " << seconds << " s (" << fs::file_size(path) / (1 << 20) << " MiB, "
+             << loadedParticles.size() << " particles)" << endl;
+        fs::remove(path);
+    };
+
+    cout << "number of particles: " << particleSize << endl;
+    ParticlesLoader::Prof prof;
+    ParticlesLoader::Csv csv;
+    ParticlesLoader::Vtu vtu;
+    exporter.toProf(dir / "particles.prof", 0.0);
+    measure("prof", dir / "particles.prof", prof);
+    exporter.toCsv(dir / "particles.csv", 0.0);
+    measure("csv", dir / "particles.csv", csv);
+    exporter.toVtu(dir / "ascii.vtu", 0.0, 1.0, false);
+    measure("vtu (ascii)", dir / "ascii.vtu", vtu);
+    exporter.toVtu(dir / "binary.vtu", 0.0, 1.0, true);
+    measure("vtu (binary)", dir / "binary.vtu", vtu);
+    exporter.toVtu(dir / "zlib.vtu", 0.0, 1.0, true, true);
+    measure("vtu (zlib)", dir / "zlib.vtu", vtu);
+    fs::remove(dir);
+
+    return 0;
+}
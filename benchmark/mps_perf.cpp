@@ -0,0 +1,294 @@
+#include "../src/loader.hpp"
+#include "../src/mps_factory.hpp"
+#include "../src/performance_report.hpp"
+
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace fs     = std::filesystem;
+namespace chrono = std::chrono;
+using std::cerr;
+using std::cout;
+using std::endl;
+
+/// @brief timings of a case with a number of threads, in seconds per time step
+struct Timings {
+    int threads{};                                      ///< number of OpenMP threads
+    double stepSeconds{};                               ///< median of the wall-clock seconds of a time step
+    double particleUpdatesPerSecond{};                  ///< number of particles updated per second
+    std::vector<std::pair<std::string, double>> stages; ///< mean seconds per time step of each stage
+};
+
+/// @brief timings stored as the reference of the comparison
+struct Baseline {
+    int steps        = 100;         ///< number of measured time steps
+    int warmupSteps  = 10;          ///< number of time steps run before the measurement
+    double tolerance = 0.5;         ///< allowed relative increase of the timings
+    std::map<int, Timings> timings; ///< timings of each number of threads
+};
+
+/**
+ * @brief run the case and measure the time steps after the warm-up steps
+ * @details No output file is written. The input files are loaded through a temporary directory, since Loader copies
+ * them to the output directory.
+ */
+Timings measure(const fs::path& settingPath, const int threads, const int warmupSteps, const int steps) {
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+    auto id                  = chrono::steady_clock::now().time_since_epoch().count();
+    fs::path outputDirectory = fs::temp_directory_path() / ("mps_perf_" + std::to_string(id));
+    fs::create_directories(outputDirectory);
+    Loader loader;
+    Input input = loader.load(settingPath, outputDirectory);
+    fs::remove_all(outputDirectory);
+
+    MPS mps = MPSFactory::create(input);
+    for (int i = 0; i < warmupSteps; i++) {
+        mps.stepForward();
+    }
+    auto warmupStageSeconds = mps.getStageSeconds();
+
+    PerformanceReport report;
+    for (int i = 0; i < steps; i++) {
+        auto begin = chrono::steady_clock::now();
+        mps.stepForward();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        report.addStep(seconds, mps.particles.size(), mps.pressureCalculator->solverIterations());
+    }
+    auto stageSeconds = mps.getStageSeconds();
+    for (auto& [stage, seconds] : stageSeconds) {
+        seconds -= warmupStageSeconds[stage];
+    }
+    report.setStageSeconds(stageSeconds);
+
+    Timings timings;
+    timings.threads                  = threads;
+    timings.stepSeconds              = report.stepSeconds().p50;
+    timings.particleUpdatesPerSecond = report.particleUpdatesPerSecond();
+    timings.stages                   = report.stageSecondsPerStep();
+    return timings;
+}
+
+Baseline readBaseline(const fs::path& path) {
+    // JSON is read as YAML, which is a superset of it
+    YAML::Node yaml;
+    try {
+        yaml = YAML::LoadFile(path.string());
+    } catch (const YAML::Exception& e) {
+        cerr << "ERROR: cannot read the baseline " << path << ": " << e.what() << endl;
+        std::exit(-1);
+    }
+
+    Baseline baseline;
+    baseline.steps       = yaml["steps"].as<int>();
+    baseline.warmupSteps = yaml["warmupSteps"].as<int>();
+    baseline.tolerance   = yaml["tolerance"].as<double>();
+    for (const auto& result : yaml["results"]) {
+        Timings timings;
+        timings.threads     = result["threads"].as<int>();
+        timings.stepSeconds = result["stepSeconds"].as<double>();
+        for (const auto& stage : result["stageSecondsPerStep"]) {
+            timings.stages.emplace_back(stage.first.as<std::string>(), stage.second.as<double>());
+        }
+        baseline.timings[timings.threads] = timings;
+    }
+    return baseline;
+}
+
+void writeBaseline(const fs::path& path, const Baseline& baseline) {
+    std::ofstream file(path);
+    file << std::setprecision(6);
+    file << "{\n";
+    file << "  \"steps\": " << baseline.steps << ",\n";
+    file << "  \"warmupSteps\": " << baseline.warmupSteps << ",\n";
+    file << "  \"tolerance\": " << baseline.tolerance << ",\n";
+    file << "  \"results\": [\n";
+    size_t count = 0;
+    for (const auto& [threads, timings] : baseline.timings) {
+        file << "    {\n";
+        file << "      \"threads\": " << threads << ",\n";
+        file << "      \"stepSeconds\": " << timings.stepSeconds << ",\n";
+        file << "      \"particleUpdatesPerSecond\": " << timings.particleUpdatesPerSecond << ",\n";
+        file << "      \"stageSecondsPerStep\": {";
+        for (size_t i = 0; i < timings.stages.size(); i++) {
+            file << (i == 0 ? "" : ", ") << "\"" << timings.stages[i].first << "\": " << timings.stages[i].second;
+        }
+        file << "}\n";
+        file << "    }" << (++count < baseline.timings.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+    file.close();
+    if (file.fail()) {
+        cerr << "ERROR: cannot write the baseline " << path << endl;
+        std::exit(-1);
+    }
+}
+
+/**
+ * @brief compare the timings with the baseline and print the result
+ * @details The median step time and the time of each stage that takes at least minShare of the step in the baseline
+ * are compared, since the time of short stages is dominated by noise.
+ * @return false if any of them is slower than the baseline by more than the tolerance
+ */
+bool compare(const Timings& measured, const Timings& reference, const double tolerance, const double minShare) {
+    double referenceTotal = 0.0;
+    for (const auto& [name, seconds] : reference.stages) {
+        referenceTotal += seconds;
+    }
+
+    bool passed = true;
+    auto check  = [&](const std::string& name, double referenceSeconds, double measuredSeconds) {
+        double ratio      = measuredSeconds / referenceSeconds;
+        bool isRegression = ratio > 1.0 + tolerance;
+        passed            = passed && !isRegression;
+        cout << std::setw(8) << measured.threads << "   " << std::left << std::setw(36) << name << std::right
+             << std::setw(14) << referenceSeconds * 1e3 << std::setw(14) << measuredSeconds * 1e3 << std::setw(8)
+             << ratio << (isRegression ? "   REGRESSION" : "") << "\n";
+    };
+
+    check("step (median)", reference.stepSeconds, measured.stepSeconds);
+    for (const auto& [name, referenceSeconds] : reference.stages) {
+        if (referenceSeconds < minShare * referenceTotal)
+            continue;
+        for (const auto& [measuredName, measuredSeconds] : measured.stages) {
+            if (measuredName == name) {
+                check(name, referenceSeconds, measuredSeconds);
+            }
+        }
+    }
+    return passed;
+}
+
+/**
+ * @brief parse comma-separated numbers of threads, e.g. "1,2,4"
+ */
+std::vector<int> parseThreadCounts(const std::string& list) {
+    std::vector<int> threadCounts;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (item.empty() || item.find_first_not_of("0123456789") != std::string::npos || std::stoi(item) <= 0) {
+            cerr << "ERROR: invalid number of threads: " << item << endl;
+            std::exit(-1);
+        }
+        threadCounts.push_back(std::stoi(item));
+    }
+    return threadCounts;
+}
+
+/**
+ * @brief Performance regression test of a simulation case
+ *
+ * @details The case is run for a fixed number of time steps without writing any output, with each of the given numbers
+ * of threads. The median time of a time step and the time of each stage are compared with a baseline, and the program
+ * fails (exit code 1) if any of them is slower than the baseline by more than the tolerance.
+ *
+ * Usage:
+ * - `mps_perf --setting input/dambreak/settings.yml --baseline benchmark/baseline/dambreak.json`
+ * - `mps_perf --setting input/dambreak/settings.yml --threads 1,2,4 --write-baseline dambreak.json`
+ */
+int main(int argc, char** argv) {
+    argparse::ArgumentParser program("mps_perf");
+    program.add_argument("-s", "--setting").required().help("path to setting file of the case");
+    program.add_argument("-b", "--baseline").help("path to the baseline to compare with");
+    program.add_argument("--write-baseline").help("path to write the measured timings to as a new baseline");
+    program.add_argument("--steps").scan<'i', int>().help("number of measured time steps (default: baseline or 100)");
+    program.add_argument("--warmup").scan<'i', int>().help("number of time steps before the measurement");
+    program.add_argument("--threads").help("comma-separated numbers of threads, e.g. 1,2,4 (default: baseline or 1)");
+    program.add_argument("--tolerance")
+        .scan<'g', double>()
+        .help("allowed relative slowdown, e.g. 0.5 for 50% (default: baseline or 0.5)");
+    program.add_argument("--min-share")
+        .scan<'g', double>()
+        .default_value(0.1)
+        .help("minimum share of a stage in the baseline to compare it");
+
+    // Exceptions are used here only because argparse reports errors by them, as in main.cpp.
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception& err) {
+        cerr << err.what() << endl;
+        cerr << program;
+        std::exit(-1);
+    }
+
+    fs::path settingPath = program.get<std::string>("--setting");
+    Baseline baseline;
+    bool hasBaseline = program.is_used("--baseline");
+    if (hasBaseline) {
+        baseline = readBaseline(program.get<std::string>("--baseline"));
+    }
+    int steps        = program.present<int>("--steps").value_or(baseline.steps);
+    int warmupSteps  = program.present<int>("--warmup").value_or(baseline.warmupSteps);
+    double tolerance = program.present<double>("--tolerance").value_or(baseline.tolerance);
+    double minShare  = program.get<double>("--min-share");
+
+    std::vector<int> threadCounts = {1};
+    if (program.is_used("--threads")) {
+        threadCounts = parseThreadCounts(program.get<std::string>("--threads"));
+    } else if (!baseline.timings.empty()) {
+        threadCounts.clear();
+        for (const auto& [threads, timings] : baseline.timings) {
+            threadCounts.push_back(threads);
+        }
+    }
+
+    std::vector<Timings> results;
+    for (const auto& threads : threadCounts) {
+#ifndef _OPENMP
+        if (threads != 1) {
+            cerr << "WARNING: built without OpenMP, so it is not measured with " << threads << " threads" << endl;
+            continue;
+        }
+#endif
+        results.push_back(measure(settingPath, threads, warmupSteps, steps));
+        const auto& timings = results.back();
+        cout << threads << " threads: " << std::fixed << std::setprecision(3) << timings.stepSeconds * 1e3
+             << " ms/step (median), " << std::scientific << timings.particleUpdatesPerSecond
+             << " particle updates/s" << std::defaultfloat << endl;
+    }
+
+    if (program.is_used("--write-baseline")) {
+        Baseline newBaseline;
+        newBaseline.steps       = steps;
+        newBaseline.warmupSteps = warmupSteps;
+        newBaseline.tolerance   = tolerance;
+        for (const auto& timings : results) {
+            newBaseline.timings[timings.threads] = timings;
+        }
+        writeBaseline(program.get<std::string>("--write-baseline"), newBaseline);
+    }
+    if (!hasBaseline)
+        return 0;
+
+    cout << endl;
+    cout << std::setw(8) << "threads" << "   " << std::left << std::setw(36) << "timing" << std::right << std::setw(14)
+         << "baseline [ms]" << std::setw(14) << "measured [ms]" << std::setw(8) << "ratio" << endl;
+    cout << std::fixed << std::setprecision(3);
+    bool passed = true;
+    for (const auto& timings : results) {
+        if (baseline.timings.count(timings.threads) == 0) {
+            cout << std::setw(8) << timings.threads << "   (no baseline)" << endl;
+            continue;
+        }
+        passed = compare(timings, baseline.timings[timings.threads], tolerance, minShare) && passed;
+    }
+    cout << endl;
+    cout << (passed ? "PASSED" : "FAILED") << " (tolerance: " << tolerance * 100.0 << "%)" << endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+#include "../src/particles_exporter.hpp"
+#include "../src/particles_view.hpp"
+#include "generator_src/case_geometry.hpp"
+
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs     = std::filesystem;
+namespace chrono = std::chrono;
+using std::cerr;
+using std::cout;
+using std::endl;
+
+/**
+ * @brief format a vector as a YAML flow sequence, e.g. [-0.1, -0.1, 0]
+ */
+std::string toYamlSequence(const Eigen::Vector3d& vector) {
+    std::stringstream ss;
+    ss << "[" << vector.x() << ", " << vector.y() << ", " << vector.z() << "]";
+    return ss.str();
+}
+
+/**
+ * @brief write the settings of the case based on a settings file of another particle distance
+ * @details The dimension, the particle distance, the domain and the path of the particles file are replaced, and the
+ * time step is scaled by the ratio of the particle distances to keep the Courant number. The other lines, including the
+ * comments, are copied as they are.
+ */
+void writeSettings(
+    const fs::path& templatePath,
+    const fs::path& settingsPath,
+    const int dim,
+    const double particleDistance,
+    const CaseGeometry& geometry,
+    const std::string& particlesFileName
+) {
+    std::ifstream templateFile(templatePath);
+    if (!templateFile.is_open()) {
+        cerr << "ERROR: cannot open the settings file " << templatePath << endl;
+        std::exit(-1);
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    double templateParticleDistance = 0.0;
+    while (std::getline(templateFile, line)) {
+        if (line.rfind("particleDistance:", 0) == 0) {
+            templateParticleDistance = std::stod(line.substr(line.find(':') + 1));
+        }
+        lines.push_back(line);
+    }
+    if (templateParticleDistance <= 0.0) {
+        cerr << "ERROR: particleDistance is not found in the settings file " << templatePath << endl;
+        std::exit(-1);
+    }
+
+    std::ofstream settingsFile(settingsPath);
+    for (const auto& line : lines) {
+        if (line.rfind("dim:", 0) == 0) {
+            settingsFile << "dim: " << dim << "\n";
+        } else if (line.rfind("particleDistance:", 0) == 0) {
+            settingsFile << "particleDistance: " << particleDistance << "\n";
+        } else if (line.rfind("dt:", 0) == 0) {
+            double dt = std::stod(line.substr(line.find(':') + 1));
+            settingsFile << "dt: " << dt * particleDistance / templateParticleDistance << "\n";
+        } else if (line.rfind("domainMin:", 0) == 0) {
+            settingsFile << "domainMin: " << toYamlSequence(geometry.domainMin) << "\n";
+        } else if (line.rfind("domainMax:", 0) == 0) {
+            settingsFile << "domainMax: " << toYamlSequence(geometry.domainMax) << "\n";
+        } else if (line.rfind("particlesPath:", 0) == 0) {
+            settingsFile << "particlesPath: ./" << particlesFileName << "\n";
+        } else {
+            settingsFile << line << "\n";
+        }
+    }
+    settingsFile.close();
+    if (settingsFile.fail()) {
+        cerr << "ERROR: cannot write the settings file " << settingsPath << endl;
+        std::exit(-1);
+    }
+}
+
+/**
+ * @brief Generator of the dam break and the hydrostatic tank cases at any particle distance in 2D and 3D
+ *
+ * @details Unlike the other generators, it does not ask anything, so that it can be used in scripts and for large
+ * cases. The particles are classified in parallel and written in one of the formats below.
+ * - vtu: binary VTK data (zlib-compressed with `--compress`), which is the fastest to write and to load.
+ * - prof, csv: text data.
+ *
+ * Usage:
+ * - `generate_case --case dambreak --dim 3 --particle-distance 0.005 --output input/dambreak3d`
+ * - `generate_case --case tank --dim 2 --particle-distance 0.006 --output input/tank --format prof
+ *   --settings input/hydrostatic/settings.yml`
+ */
+int main(int argc, char** argv) {
+    argparse::ArgumentParser program("generate_case");
+    program.add_argument("-c", "--case").required().help("case to generate: dambreak or tank");
+    program.add_argument("-d", "--dim").scan<'i', int>().default_value(2).help("dimension of the case: 2 or 3");
+    program.add_argument("-l", "--particle-distance").scan<'g', double>().required().help("distance between particles");
+    program.add_argument("-o", "--output").required().help("directory to write the particles file to");
+    program.add_argument("-f", "--format").default_value(std::string("vtu")).help("format: vtu, prof or csv");
+    program.add_argument("--compress").default_value(false).implicit_value(true).help("compress vtu by zlib");
+    program.add_argument("--no-cells")
+        .default_value(false)
+        .implicit_value(true)
+        .help("do not write a vertex cell per particle in vtu, which makes the file smaller");
+    program.add_argument("-s", "--settings").help("settings file to make settings.yml of the case from");
+    program.add_argument("--force").default_value(false).implicit_value(true).help("overwrite existing files");
+
+    // Exceptions are used here only because argparse reports errors by them, as in main.cpp.
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception& err) {
+        cerr << err.what() << endl;
+        cerr << program;
+        std::exit(-1);
+    }
+
+    std::string caseName    = program.get<std::string>("--case");
+    int dim                 = program.get<int>("--dim");
+    double particleDistance = program.get<double>("--particle-distance");
+    fs::path outputDir      = program.get<std::string>("--output");
+    std::string format      = program.get<std::string>("--format");
+    if (caseName != "dambreak" && caseName != "tank") {
+        cerr << "ERROR: unknown case: " << caseName << " (dambreak or tank)" << endl;
+        std::exit(-1);
+    }
+    if (dim != 2 && dim != 3) {
+        cerr << "ERROR: dim must be 2 or 3: " << dim << endl;
+        std::exit(-1);
+    }
+    if (particleDistance <= 0.0) {
+        cerr << "ERROR: particle distance must be positive: " << particleDistance << endl;
+        std::exit(-1);
+    }
+    if (format != "vtu" && format != "prof" && format != "csv") {
+        cerr << "ERROR: unknown format: " << format << " (vtu, prof or csv)" << endl;
+        std::exit(-1);
+    }
+
+    std::string particlesFileName = "input." + format;
+    fs::path particlesPath        = outputDir / particlesFileName;
+    fs::path settingsPath         = outputDir / "settings.yml";
+    bool writesSettings           = program.is_used("--settings");
+    if (!program.get<bool>("--force")) {
+        for (const auto& path : {particlesPath, settingsPath}) {
+            if (fs::exists(path) && (path != settingsPath || writesSettings)) {
+                cerr << "ERROR: " << path << " already exists. Use --force to overwrite it." << endl;
+                std::exit(-1);
+            }
+        }
+    }
+    fs::create_directories(outputDir);
+
+    // Only the fields the format needs are made, since they take most of the memory of large cases.
+    std::vector<ParticleField> fields = {ParticleField::Type};
+    if (format != "vtu")
+        fields.push_back(ParticleField::Velocity);
+    if (format == "csv")
+        fields.push_back(ParticleField::FluidType);
+
+    auto begin                 = chrono::steady_clock::now();
+    CaseGeometry geometry      = caseName == "dambreak" ? dambreakGeometry(particleDistance, dim)
+                                                        : tankGeometry(particleDistance, dim);
+    ParticlesSnapshot snapshot = geometry.generate(particleDistance, fields);
+    double generateSeconds     = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    cout << snapshot.size() << " particles generated in " << generateSeconds << " s" << endl;
+
+    begin = chrono::steady_clock::now();
+    ParticlesExporter exporter;
+    exporter.setParticles(ParticlesView(snapshot));
+    exporter.setFields(fields);
+    exporter.setWritesCells(!program.get<bool>("--no-cells"));
+    if (format == "vtu") {
+        exporter.toVtu(particlesPath, 0.0, 1.0, true, program.get<bool>("--compress"));
+    } else if (format == "prof") {
+        exporter.toProf(particlesPath, 0.0);
+    } else {
+        exporter.toCsv(particlesPath, 0.0);
+    }
+    double writeSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    cout << "Particles exported to " << particlesPath << " in " << writeSeconds << " s" << endl;
+
+    if (writesSettings) {
+        fs::path templatePath = program.get<std::string>("--settings");
+        writeSettings(templatePath, settingsPath, dim, particleDistance, geometry, particlesFileName);
+        cout << "Settings exported to " << settingsPath << endl;
+    }
+}
@@ -0,0 +1,90 @@
+#include "box_regions.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+Box::Box(const Eigen::Vector3d& corner1, const Eigen::Vector3d& corner2) {
+    this->min = corner1.cwiseMin(corner2);
+    this->max = corner1.cwiseMax(corner2);
+}
+
+bool Box::isInside(const Eigen::Vector3d& position, const double eps) const {
+    return (min.x() - eps < position.x() && position.x() < max.x() + eps) &&
+           (min.y() - eps < position.y() && position.y() < max.y() + eps) &&
+           (min.z() - eps < position.z() && position.z() < max.z() + eps);
+}
+
+BoxRegions::BoxRegions(const double eps) {
+    this->eps = eps;
+}
+
+void BoxRegions::add(const Box& box, const ParticleType& type) {
+    regions.emplace_back(box, type);
+}
+
+ParticleType BoxRegions::typeAt(const Eigen::Vector3d& position) const {
+    // the last box containing the position decides the type
+    for (auto region = regions.rbegin(); region != regions.rend(); region++) {
+        if (region->first.isInside(position, eps))
+            return region->second;
+    }
+    return ParticleType::Ghost;
+}
+
+ParticlesSnapshot BoxRegions::generate(
+    const Eigen::Vector3i& begin,
+    const Eigen::Vector3i& end,
+    const double particleDistance,
+    const Eigen::Vector3d& offset,
+    const std::vector<ParticleField>& fields
+) const {
+    Eigen::Vector3i size = (end - begin).cwiseMax(0);
+    auto position        = [&](int ix, int iy, int iz) {
+        return (particleDistance * (Eigen::Vector3d(ix, iy, iz) + offset)).eval();
+    };
+
+    // The particles are counted for each x index in parallel first, so that the particles of each x index can be
+    // written at their own place in the arrays in parallel while keeping the order of nested loops.
+    std::vector<size_t> offsets(size.x() + 1, 0);
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < size.x(); i++) {
+        size_t count = 0;
+        for (int iy = begin.y(); iy < end.y(); iy++) {
+            for (int iz = begin.z(); iz < end.z(); iz++) {
+                if (typeAt(position(begin.x() + i, iy, iz)) != ParticleType::Ghost)
+                    count++;
+            }
+        }
+        offsets[i + 1] = count;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    auto has            = [&fields](ParticleField field) {
+        return std::find(fields.begin(), fields.end(), field) != fields.end();
+    };
+    size_t numParticles = offsets.back();
+    ParticlesSnapshot snapshot;
+    snapshot.position.resize(numParticles);
+    snapshot.type.resize(numParticles);
+    if (has(ParticleField::Velocity))
+        snapshot.velocity.assign(numParticles, Eigen::Vector3d::Zero());
+    if (has(ParticleField::FluidType))
+        snapshot.fluidType.assign(numParticles, 0);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < size.x(); i++) {
+        size_t index = offsets[i];
+        for (int iy = begin.y(); iy < end.y(); iy++) {
+            for (int iz = begin.z(); iz < end.z(); iz++) {
+                Eigen::Vector3d pos = position(begin.x() + i, iy, iz);
+                ParticleType type   = typeAt(pos);
+                if (type == ParticleType::Ghost)
+                    continue;
+                snapshot.position[index] = pos;
+                snapshot.type[index]     = type;
+                index++;
+            }
+        }
+    }
+    return snapshot;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../../src/particle.hpp"
+#include "../../src/particle_field.hpp"
+#include "../../src/particles_snapshot.hpp"
+
+#include <Eigen/Dense>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Axis-aligned box used to define the regions of particles in generators
+ * @details The corners are sorted when the box is made, so the box is not changed when positions are checked against
+ * it and it can be used from several threads.
+ */
+class Box {
+public:
+    /**
+     * @param corner1 a corner of the box
+     * @param corner2 the opposite corner of the box. The corners can be given in any order in each direction.
+     */
+    Box(const Eigen::Vector3d& corner1, const Eigen::Vector3d& corner2);
+
+    /**
+     * @brief whether the position is inside the box
+     * @param eps margin added to each side of the box. The sides themselves are outside of the box when it is 0.
+     */
+    bool isInside(const Eigen::Vector3d& position, const double eps) const;
+
+private:
+    Eigen::Vector3d min; ///< minimum corner
+    Eigen::Vector3d max; ///< maximum corner
+};
+
+/**
+ * @brief Regions of particle types made of boxes
+ * @details The type at a position is the type of the last added box containing it, so a box can be carved out of the
+ * boxes added before it, e.g. the inside of a tank out of its walls by a box of ParticleType::Ghost. Positions outside
+ * of all the boxes are ParticleType::Ghost.
+ */
+class BoxRegions {
+public:
+    /**
+     * @param eps margin added to each side of the boxes
+     */
+    explicit BoxRegions(const double eps = 0.0);
+
+    /**
+     * @brief add a box of the type on top of the boxes added before
+     */
+    void add(const Box& box, const ParticleType& type);
+
+    /**
+     * @brief type of particles at the position
+     */
+    ParticleType typeAt(const Eigen::Vector3d& position) const;
+
+    /**
+     * @brief make particles on the lattice points that are not ghosts
+     * @details The lattice points are at `particleDistance * (index + offset)` for the indices in [begin, end). They
+     * are classified in parallel, and the particles are ordered by the x index, then the y index and the z index, as
+     * in nested loops over them.
+     * @param begin first lattice index in each direction
+     * @param end index after the last one in each direction
+     * @param particleDistance distance between the lattice points
+     * @param offset offset of the lattice points in units of the particle distance
+     * @param fields fields of the snapshot in addition to the position and the type. The velocity is zero and the
+     * fluid type is 0.
+     */
+    ParticlesSnapshot generate(
+        const Eigen::Vector3i& begin,
+        const Eigen::Vector3i& end,
+        const double particleDistance,
+        const Eigen::Vector3d& offset,
+        const std::vector<ParticleField>& fields = {}
+    ) const;
+
+private:
+    double eps;
+    std::vector<std::pair<Box, ParticleType>> regions; ///< boxes in the order they were added
+};
@@ -0,0 +1,81 @@
+#include "case_geometry.hpp"
+
+#include <cmath>
+
+ParticlesSnapshot
+CaseGeometry::generate(const double particleDistance, const std::vector<ParticleField>& fields) const {
+    return regions.generate(begin, end, particleDistance, offset, fields);
+}
+
+CaseGeometry dambreakGeometry(const double particleDistance, const int dim) {
+    double l0    = particleDistance;
+    double depth = 0.3;
+
+    // In 2D, the particles are in a single layer at z = 0, which the boxes contain.
+    auto zRange = [&](double min, double max) {
+        return dim == 2 ? std::make_pair(-0.5 * l0, 0.5 * l0) : std::make_pair(min, max);
+    };
+    auto [dummyZMin, dummyZMax] = zRange(-4.0 * l0, depth + 4.0 * l0);
+    auto [wallZMin, wallZMax]   = zRange(-2.0 * l0, depth + 2.0 * l0);
+    auto [tankZMin, tankZMax]   = zRange(0.0, depth);
+
+    CaseGeometry geometry{BoxRegions(0.01 * l0)};
+    // dummy wall region
+    geometry.regions.add(
+        Box({-4.0 * l0, -4.0 * l0, dummyZMin}, {1.0 + 4.0 * l0, 0.6, dummyZMax}), ParticleType::DummyWall
+    );
+    // wall region
+    geometry.regions.add(Box({-2.0 * l0, -2.0 * l0, wallZMin}, {1.0 + 2.0 * l0, 0.6, wallZMax}), ParticleType::Wall);
+    // wall region at the top of the dummy walls
+    geometry.regions.add(
+        Box({-4.0 * l0, 0.6 - 2.0 * l0, dummyZMin}, {1.0 + 4.0 * l0, 0.6, dummyZMax}), ParticleType::Wall
+    );
+    // empty region
+    geometry.regions.add(Box({0.0, 0.0, tankZMin}, {1.0, 0.6, tankZMax}), ParticleType::Ghost);
+    // fluid region
+    geometry.regions.add(Box({0.0, 0.0, tankZMin}, {0.25, 0.5, tankZMax}), ParticleType::Fluid);
+
+    int endZ           = dim == 2 ? 1 : (int) std::round(depth / l0) + 5;
+    geometry.begin     = Eigen::Vector3i(-4, -4, dim == 2 ? 0 : -4);
+    geometry.end       = Eigen::Vector3i((int) std::round(1.0 / l0) + 5, (int) std::round(0.6 / l0) + 5, endZ);
+    geometry.offset    = Eigen::Vector3d::Zero();
+    geometry.domainMin = Eigen::Vector3d(-0.1, -0.1, dim == 2 ? 0.0 : -0.1);
+    geometry.domainMax = Eigen::Vector3d(1.1, 2.0, dim == 2 ? 0.0 : depth + 0.1);
+    return geometry;
+}
+
+CaseGeometry tankGeometry(const double particleDistance, const int dim) {
+    double l0 = particleDistance;
+
+    // In 2D, the particles are in a single layer at z = 0, which the boxes contain.
+    auto zRange = [&](double min, double max) {
+        return dim == 2 ? std::make_pair(-0.5 * l0, 0.5 * l0) : std::make_pair(min, max);
+    };
+    auto [dummyZMin, dummyZMax] = zRange(-0.18 - 4.0 * l0, 0.18 + 4.0 * l0);
+    auto [wallZMin, wallZMax]   = zRange(-0.18 - 2.0 * l0, 0.18 + 2.0 * l0);
+    auto [tankZMin, tankZMax]   = zRange(-0.18, 0.18);
+
+    // The particles are at the centers of the cells, so they are never on the sides of the boxes.
+    CaseGeometry geometry{BoxRegions(0.0)};
+    // dummy region
+    geometry.regions.add(
+        Box({-0.18 - 4.0 * l0, -4.0 * l0, dummyZMin}, {0.18 + 4.0 * l0, 0.6, dummyZMax}), ParticleType::DummyWall
+    );
+    // wall region
+    geometry.regions.add(
+        Box({-0.18 - 2.0 * l0, -2.0 * l0, wallZMin}, {0.18 + 2.0 * l0, 0.6, wallZMax}), ParticleType::Wall
+    );
+    // fluid region
+    geometry.regions.add(Box({-0.18, 0.0, tankZMin}, {0.18, 0.48, tankZMax}), ParticleType::Fluid);
+    // empty region
+    geometry.regions.add(Box({-0.18, 0.48, tankZMin}, {0.18, 0.6, tankZMax}), ParticleType::Ghost);
+
+    int beginX         = (int) std::round(-0.18 / l0) - 4;
+    int endX           = (int) std::round(0.18 / l0) + 4;
+    geometry.begin     = Eigen::Vector3i(beginX, -4, dim == 2 ? 0 : beginX);
+    geometry.end       = Eigen::Vector3i(endX, (int) std::round(0.6 / l0), dim == 2 ? 1 : endX);
+    geometry.offset    = Eigen::Vector3d(0.5, 0.5, dim == 2 ? 0.0 : 0.5);
+    geometry.domainMin = Eigen::Vector3d(-0.25, -0.05, dim == 2 ? 0.0 : -0.25);
+    geometry.domainMax = Eigen::Vector3d(0.25, 0.6, dim == 2 ? 0.0 : 0.25);
+    return geometry;
+}
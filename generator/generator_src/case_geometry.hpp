@@ -0,0 +1,42 @@
+#pragma once
+
+#include "box_regions.hpp"
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Regions of particles and lattice of a case, which can be made at any particle distance
+ */
+struct CaseGeometry {
+    BoxRegions regions;                                 ///< regions of the particle types
+    Eigen::Vector3i begin     = Eigen::Vector3i::Zero(); ///< first lattice index in each direction
+    Eigen::Vector3i end       = Eigen::Vector3i::Zero(); ///< index after the last one in each direction
+    Eigen::Vector3d offset    = Eigen::Vector3d::Zero(); ///< offset of the lattice points in particle distances
+    Eigen::Vector3d domainMin = Eigen::Vector3d::Zero(); ///< minimum corner of the domain of the simulation
+    Eigen::Vector3d domainMax = Eigen::Vector3d::Zero(); ///< maximum corner of the domain of the simulation
+
+    /**
+     * @brief make the particles of the case
+     * @param particleDistance distance between the particles, which has to be the one the geometry was made with
+     * @param fields fields of the snapshot in addition to the position and the type
+     */
+    ParticlesSnapshot generate(const double particleDistance, const std::vector<ParticleField>& fields = {}) const;
+};
+
+/**
+ * @brief Dam break: a water column of 0.25 x 0.5 at the left of a tank of 1.0 x 0.6
+ * @details The particles are on the lattice points `particleDistance * index`. In 3D, the tank and the water column
+ * have the depth of 0.3 in the z direction.
+ * @param particleDistance distance between the particles
+ * @param dim dimension of the case (2 or 3)
+ */
+CaseGeometry dambreakGeometry(const double particleDistance, const int dim);
+
+/**
+ * @brief Hydrostatic tank: water of 0.36 x 0.48 at rest in a tank of 0.36 x 0.6
+ * @details The particles are at the centers of the lattice cells `particleDistance * (index + 0.5)`. In 3D, the tank
+ * is 0.36 x 0.36 in the horizontal directions.
+ * @param particleDistance distance between the particles
+ * @param dim dimension of the case (2 or 3)
+ */
+CaseGeometry tankGeometry(const double particleDistance, const int dim);
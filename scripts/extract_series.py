@@ -0,0 +1,59 @@
+"""Extract frames of a VTU series (output.vtus) into VTU files and a ParaView collection (.pvd).
+
+Usage: python3 scripts/extract_series.py <series.vtus> <output_directory> [first [last]]
+
+Frames first to last (inclusive, all by default) are written as output_XXXX.vtu
+together with output.pvd, which can be opened in ParaView as a time series.
+"""
+
+import os
+import struct
+import sys
+
+HEADER_SIZE = 16
+RECORD = struct.Struct("=dQQQ")  # time, offset, size, number of particles
+
+
+def read_index(series_path):
+    with open(series_path + ".idx", "rb") as index:
+        header = index.read(HEADER_SIZE)
+        if len(header) < HEADER_SIZE or header[:8] != b"MPSVTUS\0":
+            sys.exit("not an index file of a VTU series: " + series_path + ".idx")
+        version, byte_order_mark = struct.unpack("=II", header[8:])
+        if byte_order_mark != 0x01020304 or version != 1:
+            sys.exit("unsupported index file: " + series_path + ".idx")
+        records = index.read()
+    count = len(records) // RECORD.size
+    return [RECORD.unpack_from(records, i * RECORD.size) for i in range(count)]
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    series_path, output_directory = sys.argv[1], sys.argv[2]
+    frames = read_index(series_path)
+    first = int(sys.argv[3]) if len(sys.argv) > 3 else 0
+    last = int(sys.argv[4]) if len(sys.argv) > 4 else len(frames) - 1
+
+    os.makedirs(output_directory, exist_ok=True)
+    datasets = []
+    with open(series_path, "rb") as data:
+        for number in range(first, min(last, len(frames) - 1) + 1):
+            time, offset, size, _ = frames[number]
+            # each frame is a complete VTU file, so it is copied as it is
+            data.seek(offset)
+            name = "output_{:04d}.vtu".format(number)
+            with open(os.path.join(output_directory, name), "wb") as vtu:
+                vtu.write(data.read(size))
+            datasets.append('<DataSet timestep="{!r}" file="{}"/>'.format(time, name))
+
+    with open(os.path.join(output_directory, "output.pvd"), "w") as pvd:
+        pvd.write('<?xml version="1.0"?>\n')
+        pvd.write('<VTKFile type="Collection" version="1.0">\n<Collection>\n')
+        pvd.write("\n".join(datasets) + "\n")
+        pvd.write("</Collection>\n</VTKFile>\n")
+    print("{} frames written to {}".format(len(datasets), output_directory))
+
+
+if __name__ == "__main__":
+    main()
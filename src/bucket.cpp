@@ -1,8 +1,5 @@
 #include "bucket.hpp"
 
-using std::cerr;
-using std::endl;
-
 void Bucket::generate(const int& particleNum) {
     next.resize(particleNum);
 }
@@ -28,6 +25,8 @@ void Bucket::storeParticles(Particles& particles) {
         first[i] = -1;
         last[i]  = -1;
     }
+    // the number of particles can grow, e.g. when particles move in from other processes in the distributed mode
+    next.resize(particles.size());
 #pragma omp parallel for
     for (int i = 0; i < particles.size(); i++) {
         next[i] = -1;
@@ -37,23 +36,6 @@ void Bucket::storeParticles(Particles& particles) {
         if (p.type == ParticleType::Ghost)
             continue;
 
-        bool isInDomain = true;
-        if (p.position.x() < domain.xMin || domain.xMax < p.position.x())
-            isInDomain = false;
-        if (p.position.y() < domain.yMin || domain.yMax < p.position.y())
-            isInDomain = false;
-        if (p.position.z() < domain.zMin || domain.zMax < p.position.z())
-            isInDomain = false;
-        if (!isInDomain) {
-            cerr << "WARNING: particle " << p.id << " is out of domain." << endl;
-            cerr << "x = " << p.position.x() << " ";
-            cerr << "y = " << p.position.y() << " ";
-            cerr << "z = " << p.position.z() << endl;
-            p.type = ParticleType::Ghost;
-            continue;
-            // std::exit(-1);
-        }
-
         int ix      = (int) ((p.position.x() - domain.xMin) / length) + 1;
         int iy      = (int) ((p.position.y() - domain.yMin) / length) + 1;
         int iz      = (int) ((p.position.z() - domain.zMin) / length) + 1;
@@ -66,3 +48,7 @@ void Bucket::storeParticles(Particles& particles) {
         last[iBucket] = p.id;
     }
 }
+
+int Bucket::getFirst(const int& ix, const int& iy, const int& iz) const {
+    return first[ix + iy * numX + iz * numX * numY];
+}
@@ -28,8 +28,17 @@ public:
     void generate(const int& particleNum);
     /**
      * @brief store particles in the bucket
-     * @param particles particles to be stored
-     * @param domain domain of the simulation
+     * @param particles particles to be stored. Particles out of the domain have to be ghost particles (see
+     * NeighborSearcher::ghostParticlesOutOfDomain()).
      */
     void storeParticles(Particles& particles);
+
+    /**
+     * @brief first particle in the cell
+     * @param ix index of the cell in x direction
+     * @param iy index of the cell in y direction
+     * @param iz index of the cell in z direction
+     * @return id of the particle, or -1 if the cell is empty
+     */
+    int getFirst(const int& ix, const int& iy, const int& iz) const;
 };
@@ -0,0 +1,374 @@
+#include "checkpoint.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <zlib.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using std::cerr;
+using std::endl;
+namespace fs = std::filesystem;
+
+bool Checkpoint::serialize(const Particles& particles, const std::function<bool(const char*, size_t)>& output) const {
+    size_t numParticles = particles.size();
+    bool isWritten      = true;
+    uint32_t crc        = 0;
+
+    auto appendBytes = [&](const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        crc               = checksum(bytes, size, crc);
+        isWritten         = isWritten && output(bytes, size);
+    };
+    auto appendValue = [&](const auto& value) {
+        appendBytes(&value, sizeof(value));
+    };
+    auto appendVector = [&](const auto& values) {
+        appendBytes(values.data(), values.size() * sizeof(values[0]));
+    };
+    // gather a field of all the particles and pass it to the output, so that only one array is held at a time
+    std::vector<char> array;
+    auto appendArray = [&](auto field) {
+        using T = decltype(field(particles[0]));
+
+        array.resize(numParticles * sizeof(T));
+        char* bytes = array.data();
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(numParticles); i++) {
+            T value = field(particles[i]);
+            std::memcpy(bytes + i * sizeof(T), &value, sizeof(T));
+        }
+        appendBytes(bytes, array.size());
+    };
+
+    // header
+    appendBytes(magic, sizeof(magic));
+    appendValue(version);
+    appendValue(byteOrderMark);
+    appendValue(startTime);
+    appendValue(time);
+    appendValue(static_cast<int64_t>(timeStep));
+    appendValue(static_cast<int64_t>(fileNumber));
+    appendValue(static_cast<int64_t>(stepsSinceCompaction));
+    appendValue(static_cast<int64_t>(numParticles));
+    appendValue(static_cast<int64_t>(neighborSearcherState.callsSinceSearch));
+    appendValue(static_cast<uint8_t>(neighborSearcherState.isSearchRequested));
+    appendValue(static_cast<uint8_t>(hasNeighbors));
+    appendValue(static_cast<int64_t>(neighborSearcherState.positionsAtSearch.size()));
+
+    // particles
+    appendArray([](const Particle& p) { return static_cast<int32_t>(p.originalId); });
+    appendArray([](const Particle& p) { return static_cast<int32_t>(p.type); });
+    appendArray([](const Particle& p) { return static_cast<int32_t>(p.fluidType); });
+    appendArray([](const Particle& p) { return static_cast<int32_t>(p.boundaryCondition); });
+    appendArray([](const Particle& p) { return Eigen::Vector3d(p.position); });
+    appendArray([](const Particle& p) { return Eigen::Vector3d(p.velocity); });
+    appendArray([](const Particle& p) { return Eigen::Vector3d(p.acceleration); });
+    appendArray([](const Particle& p) { return p.pressure; });
+    appendArray([](const Particle& p) { return p.numberDensity; });
+    appendArray([](const Particle& p) { return p.density; });
+    appendArray([](const Particle& p) { return p.sourceTerm; });
+    appendArray([](const Particle& p) { return p.minimumPressure; });
+    array = std::vector<char>();
+    appendVector(neighborSearcherState.positionsAtSearch);
+
+    // neighbor lists in compressed sparse row format
+    if (hasNeighbors) {
+        std::vector<int64_t> offsets(numParticles + 1, 0);
+        for (size_t i = 0; i < numParticles; i++) {
+            offsets[i + 1] = offsets[i] + particles[i].neighbors.size();
+        }
+        appendVector(offsets);
+
+        std::vector<int32_t> ids(offsets.back());
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(numParticles); i++) {
+            for (size_t n = 0; n < particles[i].neighbors.size(); n++) {
+                ids[offsets[i] + n] = particles[i].neighbors[n].id;
+            }
+        }
+        appendVector(ids);
+        ids = std::vector<int32_t>();
+
+        std::vector<double> distances(offsets.back());
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(numParticles); i++) {
+            for (size_t n = 0; n < particles[i].neighbors.size(); n++) {
+                distances[offsets[i] + n] = particles[i].neighbors[n].distance;
+            }
+        }
+        appendVector(distances);
+    }
+
+    isWritten = isWritten && output(reinterpret_cast<const char*>(&crc), sizeof(crc));
+    return isWritten;
+}
+
+std::vector<char> Checkpoint::serialize(const Particles& particles) const {
+    std::vector<char> content;
+    serialize(particles, [&content](const char* data, size_t size) {
+        content.insert(content.end(), data, data + size);
+        return true;
+    });
+    return content;
+}
+
+bool Checkpoint::write(const fs::path& path, const Particles& particles) const {
+    return writeFile(path, [&](FILE* file) {
+        return serialize(particles, [file](const char* data, size_t size) {
+            return std::fwrite(data, 1, size, file) == size;
+        });
+    });
+}
+
+bool Checkpoint::writeFile(const fs::path& path, const std::vector<char>& content) {
+    return writeFile(path, [&content](FILE* file) {
+        return std::fwrite(content.data(), 1, content.size(), file) == content.size();
+    });
+}
+
+bool Checkpoint::writeFile(const fs::path& path, const std::function<bool(FILE*)>& writeContent) {
+    fs::path temporaryPath = path;
+    temporaryPath += ".tmp";
+
+    FILE* file = std::fopen(temporaryPath.string().c_str(), "wb");
+    if (file == nullptr) {
+        cerr << "WARNING: cannot write checkpoint file: " << fs::absolute(temporaryPath) << endl;
+        return false;
+    }
+    bool isWritten = writeContent(file);
+    isWritten      = isWritten && std::fflush(file) == 0;
+    // flush the file to the disk before it replaces the old one
+#ifdef _WIN32
+    isWritten = isWritten && _commit(_fileno(file)) == 0;
+#else
+    isWritten = isWritten && fsync(fileno(file)) == 0;
+#endif
+    isWritten = (std::fclose(file) == 0) && isWritten;
+
+    std::error_code error;
+    if (isWritten) {
+        fs::rename(temporaryPath, path, error);
+    }
+    if (!isWritten || error) {
+        cerr << "WARNING: failed to write checkpoint file: " << fs::absolute(path) << endl;
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+
+#ifndef _WIN32
+    // flush the directory as well so that the rename survives a crash
+    fs::path directory      = path.has_parent_path() ? path.parent_path() : fs::path(".");
+    int directoryDescriptor = open(directory.string().c_str(), O_RDONLY);
+    if (directoryDescriptor >= 0) {
+        fsync(directoryDescriptor);
+        close(directoryDescriptor);
+    }
+#endif
+    return true;
+}
+
+std::pair<Checkpoint, Particles> Checkpoint::read(const fs::path& path) {
+    auto error = [&path](const std::string& message) {
+        cerr << "Error: " << message << ": " << fs::absolute(path) << endl;
+        std::exit(-1);
+    };
+
+    std::vector<char> content;
+    if (!readFile(path, content)) {
+        error("cannot read checkpoint file");
+    }
+    std::string problem = check(content);
+    if (!problem.empty()) {
+        error(problem);
+    }
+
+    // the checksum at the end has already been checked
+    size_t pos = 0, end = content.size() - sizeof(uint32_t);
+    auto readBytes = [&](void* data, size_t size) {
+        if (size > end - pos)
+            error("checkpoint file is truncated");
+        std::memcpy(data, content.data() + pos, size);
+        pos += size;
+    };
+    auto readValue = [&](auto& value) {
+        readBytes(&value, sizeof(value));
+    };
+    auto readVector = [&](auto& values, size_t size) {
+        if (size > (end - pos) / sizeof(values[0]))
+            error("checkpoint file is truncated");
+        values.resize(size);
+        readBytes(values.data(), size * sizeof(values[0]));
+    };
+
+    // header (magic, version and byte order mark have been checked)
+    pos = sizeof(magic) + 2 * sizeof(uint32_t);
+    Checkpoint checkpoint;
+    int64_t timeStep, fileNumber, stepsSinceCompaction, numParticles, callsSinceSearch, numPositionsAtSearch;
+    uint8_t isSearchRequested, hasNeighbors;
+    readValue(checkpoint.startTime);
+    readValue(checkpoint.time);
+    readValue(timeStep);
+    readValue(fileNumber);
+    readValue(stepsSinceCompaction);
+    readValue(numParticles);
+    readValue(callsSinceSearch);
+    readValue(isSearchRequested);
+    readValue(hasNeighbors);
+    readValue(numPositionsAtSearch);
+    checkpoint.timeStep                                = static_cast<int>(timeStep);
+    checkpoint.fileNumber                              = static_cast<int>(fileNumber);
+    checkpoint.stepsSinceCompaction                    = static_cast<int>(stepsSinceCompaction);
+    checkpoint.neighborSearcherState.callsSinceSearch  = static_cast<int>(callsSinceSearch);
+    checkpoint.neighborSearcherState.isSearchRequested = (isSearchRequested != 0);
+    checkpoint.hasNeighbors                            = (hasNeighbors != 0);
+
+    // particles
+    size_t n = static_cast<size_t>(numParticles);
+    std::vector<int32_t> originalIds, types, fluidTypes, boundaryConditions;
+    std::vector<Eigen::Vector3d> positions, velocities, accelerations;
+    std::vector<double> pressures, numberDensities, densities, sourceTerms, minimumPressures;
+    readVector(originalIds, n);
+    readVector(types, n);
+    readVector(fluidTypes, n);
+    readVector(boundaryConditions, n);
+    readVector(positions, n);
+    readVector(velocities, n);
+    readVector(accelerations, n);
+    readVector(pressures, n);
+    readVector(numberDensities, n);
+    readVector(densities, n);
+    readVector(sourceTerms, n);
+    readVector(minimumPressures, n);
+    readVector(checkpoint.neighborSearcherState.positionsAtSearch, static_cast<size_t>(numPositionsAtSearch));
+
+    Particles particles;
+    particles.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        auto type = static_cast<ParticleType>(types[i]);
+        particles.add(Particle(i, type, positions[i], velocities[i], densities[i], fluidTypes[i]));
+        Particle& p         = particles[i];
+        p.originalId        = originalIds[i];
+        p.boundaryCondition = static_cast<FluidState>(boundaryConditions[i]);
+        p.acceleration      = accelerations[i];
+        p.pressure          = pressures[i];
+        p.numberDensity     = numberDensities[i];
+        p.sourceTerm        = sourceTerms[i];
+        p.minimumPressure   = minimumPressures[i];
+    }
+
+    // neighbor lists
+    if (checkpoint.hasNeighbors) {
+        std::vector<int64_t> offsets;
+        std::vector<int32_t> ids;
+        std::vector<double> distances;
+        readVector(offsets, n + 1);
+        readVector(ids, static_cast<size_t>(offsets.back()));
+        readVector(distances, static_cast<size_t>(offsets.back()));
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(n); i++) {
+            auto& neighbors = particles[i].neighbors;
+            neighbors.reserve(offsets[i + 1] - offsets[i]);
+            for (int64_t k = offsets[i]; k < offsets[i + 1]; k++) {
+                neighbors.emplace_back(ids[k], distances[k]);
+            }
+        }
+    }
+
+    return {std::move(checkpoint), std::move(particles)};
+}
+
+bool Checkpoint::isValid(const fs::path& path) {
+    std::vector<char> content;
+    return readFile(path, content) && check(content).empty();
+}
+
+fs::path Checkpoint::findLatest(const fs::path& directory) {
+    auto paths = list(directory);
+    for (auto path = paths.rbegin(); path != paths.rend(); path++) {
+        if (isValid(*path))
+            return *path;
+
+        cerr << "WARNING: invalid checkpoint file is skipped: " << fs::absolute(*path) << endl;
+        fs::path invalidPath = *path;
+        invalidPath += ".invalid";
+        std::error_code error;
+        fs::rename(*path, invalidPath, error);
+    }
+    return {};
+}
+
+std::string Checkpoint::fileName(int timeStep) {
+    std::stringstream name;
+    name << "checkpoint_" << std::setfill('0') << std::setw(8) << timeStep << ".ckpt";
+    return name.str();
+}
+
+std::vector<fs::path> Checkpoint::list(const fs::path& directory) {
+    std::vector<fs::path> paths;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (entry.is_regular_file() && name.rfind("checkpoint_", 0) == 0 && entry.path().extension() == ".ckpt") {
+            paths.push_back(entry.path());
+        }
+    }
+    // the time step in the names is padded with zeros, so the names are in the order of time steps
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+bool Checkpoint::readFile(const fs::path& path, std::vector<char>& content) {
+    std::ifstream file(path, std::ios::binary);
+    if (file.fail())
+        return false;
+
+    file.seekg(0, std::ios::end);
+    content.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(content.data(), content.size());
+    return !file.fail();
+}
+
+std::string Checkpoint::check(const std::vector<char>& content) {
+    size_t headerSize = sizeof(magic) + 2 * sizeof(uint32_t);
+    if (content.size() < headerSize + sizeof(uint32_t))
+        return "checkpoint file is truncated";
+    if (std::memcmp(content.data(), magic, sizeof(magic)) != 0)
+        return "not a checkpoint file";
+
+    uint32_t fileVersion, fileByteOrderMark, fileChecksum;
+    std::memcpy(&fileVersion, content.data() + sizeof(magic), sizeof(uint32_t));
+    std::memcpy(&fileByteOrderMark, content.data() + sizeof(magic) + sizeof(uint32_t), sizeof(uint32_t));
+    if (fileByteOrderMark != byteOrderMark)
+        return "checkpoint files of the other byte order are not supported";
+    if (fileVersion != version)
+        return "checkpoint file of version " + std::to_string(fileVersion) + " is not supported";
+
+    size_t bodySize = content.size() - sizeof(uint32_t);
+    std::memcpy(&fileChecksum, content.data() + bodySize, sizeof(uint32_t));
+    if (fileChecksum != checksum(content.data(), bodySize))
+        return "checksum of checkpoint file does not match";
+    return "";
+}
+
+uint32_t Checkpoint::checksum(const char* data, size_t size, uint32_t previous) {
+    // zlib takes the length as 32-bit integer, so large data are given in pieces
+    constexpr size_t pieceSize = 1 << 30;
+    uLong crc                  = previous;
+    for (size_t offset = 0; offset < size; offset += pieceSize) {
+        uInt length = static_cast<uInt>(std::min(pieceSize, size - offset));
+        crc         = crc32(crc, reinterpret_cast<const Bytef*>(data + offset), length);
+    }
+    return static_cast<uint32_t>(crc);
+}
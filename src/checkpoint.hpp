@@ -0,0 +1,134 @@
+#pragma once
+
+#include "common.hpp"
+#include "neighbor_searcher.hpp"
+#include "particles.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Binary checkpoint of a simulation
+ *
+ * @details A checkpoint holds everything that is carried from one time step to the next, so that a simulation
+ * restarted from it gives bit-exactly the same results as the simulation that wrote it.
+ *
+ * The file starts with a header of the magic string "MPSCKPT", the version of the format, a byte order mark and the
+ * scalar values of the checkpoint. The header is followed by the arrays of the particles (structure of arrays). The
+ * neighbor lists are written only when the neighbor searcher reuses them in later time steps. The file ends with the
+ * CRC-32 checksum of everything before it, so that a partially written or corrupted file is detected.
+ */
+class Checkpoint {
+public:
+    static constexpr uint32_t version = 2; ///< version of the file format. Increment it when the format changes.
+
+    double startTime{};                            ///< time when the simulation was started from the input file
+    double time{};                                 ///< current time of the simulation
+    int timeStep{};                                ///< number of time steps done
+    int fileNumber{};                              ///< number of output files written by Saver
+    int stepsSinceCompaction{};                    ///< see MPS::getStepsSinceCompaction()
+    NeighborSearcher::State neighborSearcherState; ///< state of the neighbor searcher
+    bool hasNeighbors{};                           ///< whether the neighbor lists of the particles are saved
+
+    /**
+     * @brief pass the content of the checkpoint file of the checkpoint and the particles to the output piece by piece
+     * @details The arrays of the particles are gathered one at a time, so at most one array is held besides the
+     * particles. The checksum is calculated from the pieces.
+     * @param particles particles of the simulation
+     * @param output function that writes a piece of the content and returns false if it could not be written
+     * @return false if any piece could not be written
+     */
+    bool serialize(const Particles& particles, const std::function<bool(const char*, size_t)>& output) const;
+
+    /**
+     * @brief content of the checkpoint file of the checkpoint and the particles
+     * @details The whole file is held in memory, e.g. so that the particles can be changed while it is written.
+     * @param particles particles of the simulation
+     */
+    std::vector<char> serialize(const Particles& particles) const;
+
+    /**
+     * @brief write the checkpoint and the particles to a file
+     * @details The content is written piece by piece as it is serialized, without holding the whole file in memory.
+     * @param path path to the checkpoint file
+     * @param particles particles of the simulation
+     * @return false if the file could not be written
+     */
+    bool write(const std::filesystem::path& path, const Particles& particles) const;
+
+    /**
+     * @brief write the content of a checkpoint file so that the file is either complete or absent after a crash
+     * @details The content is written to a temporary file, flushed to the disk and renamed to the path.
+     * @param path path to the checkpoint file
+     * @param content content of the checkpoint file made by serialize()
+     * @return false if the file could not be written
+     */
+    static bool writeFile(const std::filesystem::path& path, const std::vector<char>& content);
+
+    /**
+     * @brief read a checkpoint file
+     * @details The program exits if the file is not a valid checkpoint file.
+     * @param path path to the checkpoint file
+     * @return pair of the checkpoint and the particles
+     */
+    static std::pair<Checkpoint, Particles> read(const std::filesystem::path& path);
+
+    /**
+     * @brief whether the file is a complete checkpoint file of the current version with the correct checksum
+     */
+    static bool isValid(const std::filesystem::path& path);
+
+    /**
+     * @brief find the newest valid checkpoint file in the directory
+     * @details Checkpoint files are ordered by their names, which contain the time step. Invalid files newer than the
+     * found one are renamed with the suffix ".invalid" so that they are not used or kept by mistake.
+     * @param directory directory of checkpoint files
+     * @return path to the checkpoint file, or an empty path if there is no valid one
+     */
+    static std::filesystem::path findLatest(const std::filesystem::path& directory);
+
+    /**
+     * @brief name of the checkpoint file of the time step
+     */
+    static std::string fileName(int timeStep);
+
+    /**
+     * @brief checkpoint files in the directory ordered from the oldest
+     */
+    static std::vector<std::filesystem::path> list(const std::filesystem::path& directory);
+
+private:
+    static constexpr char magic[8]          = "MPSCKPT";  ///< first bytes of a checkpoint file
+    static constexpr uint32_t byteOrderMark = 0x01020304; ///< used to detect files of the other byte order
+
+    /**
+     * @brief read the whole file
+     * @return false if the file cannot be read
+     */
+    static bool readFile(const std::filesystem::path& path, std::vector<char>& content);
+
+    /**
+     * @brief write a checkpoint file through a temporary file (see writeFile(path, content))
+     * @param path path to the checkpoint file
+     * @param writeContent function that writes the content to the temporary file and returns false if it could not
+     * @return false if the file could not be written
+     */
+    static bool writeFile(const std::filesystem::path& path, const std::function<bool(FILE*)>& writeContent);
+
+    /**
+     * @brief check the header and the checksum of the content of a checkpoint file
+     * @return description of the problem, or an empty string if the content is valid
+     */
+    static std::string check(const std::vector<char>& content);
+
+    /**
+     * @brief CRC-32 checksum of the data
+     * @param previous checksum of the data before it, to calculate the checksum of data given in pieces
+     */
+    static uint32_t checksum(const char* data, size_t size, uint32_t previous = 0);
+};
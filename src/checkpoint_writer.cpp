@@ -0,0 +1,64 @@
+#include "checkpoint_writer.hpp"
+
+#include <iostream>
+#include <utility>
+
+using std::cerr;
+using std::endl;
+namespace fs = std::filesystem;
+
+CheckpointWriter::CheckpointWriter(const fs::path& directory, const int numKept, const bool async) {
+    this->directory = directory;
+    this->numKept   = numKept;
+    this->async     = async;
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    finish();
+}
+
+void CheckpointWriter::write(const Checkpoint& checkpoint, const Particles& particles, const bool isLast) {
+    fs::path path = directory / Checkpoint::fileName(checkpoint.timeStep);
+    if (!async || isLast) {
+        finish();
+        fs::create_directories(directory);
+        writeAndPrune([&] { return checkpoint.write(path, particles); });
+        return;
+    }
+
+    std::vector<char> content = checkpoint.serialize(particles);
+    finish();
+    fs::create_directories(directory);
+    writerThread = std::thread([this, path, content = std::move(content)] {
+        writeAndPrune([&] { return Checkpoint::writeFile(path, content); });
+    });
+}
+
+void CheckpointWriter::finish() {
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+}
+
+double CheckpointWriter::getWriteSeconds() const {
+    return writeSeconds;
+}
+
+void CheckpointWriter::writeAndPrune(const std::function<bool()>& writeFile) {
+    auto start   = std::chrono::steady_clock::now();
+    bool written = writeFile();
+    writeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // the old files are kept if the new one could not be written
+    if (!written || numKept <= 0)
+        return;
+
+    auto paths = Checkpoint::list(directory);
+    for (size_t i = 0; i + numKept < paths.size(); i++) {
+        std::error_code error;
+        fs::remove(paths[i], error);
+        if (error) {
+            cerr << "WARNING: cannot remove old checkpoint file: " << fs::absolute(paths[i]) << endl;
+        }
+    }
+}
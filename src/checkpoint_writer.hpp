@@ -0,0 +1,72 @@
+#pragma once
+
+#include "checkpoint.hpp"
+#include "common.hpp"
+#include "particles.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+/**
+ * @brief Writes checkpoint files in a background thread and keeps only the newest ones
+ *
+ * @details In the async mode, write() serializes the checkpoint in the calling thread, so that the particles can be
+ * changed right after it returns, and writes the file in a writer thread. Only one file is written at a time: write()
+ * waits for the previous file before starting the next one, which bounds the memory used by the serialized copies.
+ * Otherwise, and for the last checkpoint of a simulation, the file is written in write() piece by piece as it is
+ * serialized, without a copy of the whole file. A file is always written through a temporary file, so a crash while
+ * writing never leaves a partial file in place of a checkpoint.
+ */
+class CheckpointWriter {
+public:
+    /**
+     * @param directory directory where checkpoint files are written
+     * @param numKept number of the newest checkpoint files kept in the directory (0: all of them are kept)
+     * @param async if true, files are written in a writer thread. Otherwise they are written in write().
+     */
+    CheckpointWriter(const std::filesystem::path& directory, const int numKept, const bool async);
+
+    /**
+     * @brief wait for the file being written
+     */
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&)            = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    /**
+     * @brief write a checkpoint file named after the time step of the checkpoint
+     * @param checkpoint checkpoint to write
+     * @param particles particles of the simulation. They can be changed after this call.
+     * @param isLast whether the particles are not changed any more, e.g. at the end of the simulation. The file is
+     * then written in this call even in the async mode, since nothing would run at the same time.
+     */
+    void write(const Checkpoint& checkpoint, const Particles& particles, const bool isLast = false);
+
+    /**
+     * @brief wait until the file being written has been written
+     */
+    void finish();
+
+    /**
+     * @brief total wall-clock seconds spent in writing the files
+     * @details It should be called after finish(), since the file being written is not counted and is written by
+     * another thread.
+     */
+    double getWriteSeconds() const;
+
+private:
+    std::filesystem::path directory;
+    int numKept;
+    bool async;
+    std::thread writerThread;
+    double writeSeconds{}; ///< total wall-clock seconds spent in writing the files
+
+    /**
+     * @brief write a file by the function and remove the checkpoint files older than the newest #numKept files
+     * @param writeFile function that writes the file and returns false if it could not be written
+     */
+    void writeAndPrune(const std::function<bool()>& writeFile);
+};
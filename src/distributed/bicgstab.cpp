@@ -0,0 +1,102 @@
+#include "bicgstab.hpp"
+
+#include <cmath>
+
+using Distributed::BiCGSTAB;
+
+BiCGSTAB::BiCGSTAB(const Communicator& communicator, const HaloExchange& haloExchange) {
+    this->communicator = &communicator;
+    this->haloExchange = &haloExchange;
+}
+
+Eigen::VectorXd
+BiCGSTAB::solve(const Eigen::SparseMatrix<double, Eigen::RowMajor>& matrix, const Eigen::VectorXd& rightHandSide) {
+    int numOwned = haloExchange->getNumOwned();
+
+    // diagonal preconditioner
+    Eigen::VectorXd inverseDiagonal = Eigen::VectorXd::Ones(numOwned);
+    for (int i = 0; i < numOwned; i++) {
+        double diagonal = matrix.coeff(i, i);
+        if (diagonal != 0.0)
+            inverseDiagonal[i] = 1.0 / diagonal;
+    }
+
+    // The initial guess is zero, and the maximum number of iterations is twice the size of the whole system as in
+    // Eigen::BiCGSTAB.
+    Eigen::VectorXd x       = Eigen::VectorXd::Zero(numOwned);
+    Eigen::VectorXd r       = rightHandSide;
+    Eigen::VectorXd r0      = r;
+    double r0SquaredNorm    = dot(r0, r0);
+    double rhsSquaredNorm   = dot(rightHandSide, rightHandSide);
+    long long maxIterations = 2 * communicator->sum(static_cast<long long>(numOwned));
+    iterations              = 0;
+    converged               = true;
+    if (rhsSquaredNorm == 0.0)
+        return x;
+
+    double rho        = 1.0;
+    double alpha      = 1.0;
+    double w          = 1.0;
+    Eigen::VectorXd v = Eigen::VectorXd::Zero(numOwned);
+    Eigen::VectorXd p = Eigen::VectorXd::Zero(numOwned);
+    Eigen::VectorXd y, z, s, t;
+
+    double tolerance2 = tolerance * tolerance * rhsSquaredNorm;
+    double eps2       = Eigen::NumTraits<double>::epsilon() * Eigen::NumTraits<double>::epsilon();
+    int restarts      = 0;
+    double residual2  = dot(r, r);
+    while (residual2 > tolerance2 && iterations < maxIterations) {
+        double rhoOld = rho;
+        rho           = dot(r0, r);
+        if (std::abs(rho) < eps2 * r0SquaredNorm) {
+            // The residual has become too orthogonal to r0, so the iteration is restarted with a new r0.
+            r             = rightHandSide - multiply(matrix, x);
+            r0            = r;
+            rho           = dot(r, r);
+            r0SquaredNorm = rho;
+            if (restarts++ == 0)
+                iterations = 0;
+        }
+        double beta = (rho / rhoOld) * (alpha / w);
+        p           = r + beta * (p - w * v);
+
+        y     = inverseDiagonal.cwiseProduct(p);
+        v     = multiply(matrix, y);
+        alpha = rho / dot(r0, v);
+        s     = r - alpha * v;
+
+        z             = inverseDiagonal.cwiseProduct(s);
+        t             = multiply(matrix, z);
+        double tNorm2 = dot(t, t);
+        w             = tNorm2 > 0.0 ? dot(t, s) / tNorm2 : 0.0;
+
+        x += alpha * y + w * z;
+        r = s - w * t;
+        iterations++;
+        residual2 = dot(r, r);
+    }
+    converged = std::sqrt(residual2 / rhsSquaredNorm) <= tolerance;
+    return x;
+}
+
+int BiCGSTAB::getIterations() const {
+    return iterations;
+}
+
+bool BiCGSTAB::hasConverged() const {
+    return converged;
+}
+
+Eigen::VectorXd BiCGSTAB::multiply(
+    const Eigen::SparseMatrix<double, Eigen::RowMajor>& matrix, const Eigen::VectorXd& ownValues
+) const {
+    int numOwned           = haloExchange->getNumOwned();
+    Eigen::VectorXd values = Eigen::VectorXd::Zero(matrix.cols());
+    values.head(numOwned)  = ownValues;
+    haloExchange->refresh(values);
+    return matrix.topRows(numOwned) * values;
+}
+
+double BiCGSTAB::dot(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const {
+    return communicator->sum(a.dot(b));
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "communicator.hpp"
+#include "halo_exchange.hpp"
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+namespace Distributed {
+
+/**
+ * @brief BiCGSTAB method with the diagonal (Jacobi) preconditioner for a linear system distributed over the processes
+ *
+ * @details Each process has the rows of its own particles. The columns are the own particles followed by the halo
+ * particles, whose values are received from their owners by HaloExchange::refresh() before each product of the
+ * matrix and a vector. The algorithm, the preconditioner and the stopping criterion are the same as those of
+ * Eigen::BiCGSTAB used in the shared memory mode, so the iterations differ only by rounding errors of the sums over
+ * the processes.
+ */
+class BiCGSTAB {
+public:
+    BiCGSTAB() = default;
+
+    /**
+     * @param communicator communicator of the processes, which has to outlive this object
+     * @param haloExchange exchange of the halo particles of the rows, which has to outlive this object
+     */
+    BiCGSTAB(const Communicator& communicator, const HaloExchange& haloExchange);
+
+    /**
+     * @brief solve the linear system
+     * @param matrix rows of the own particles. Only the first HaloExchange::getNumOwned() rows are used, and the
+     * number of the columns is the number of the own and the halo particles.
+     * @param rightHandSide right-hand side of the own particles
+     * @return solution of the own particles
+     */
+    Eigen::VectorXd
+    solve(const Eigen::SparseMatrix<double, Eigen::RowMajor>& matrix, const Eigen::VectorXd& rightHandSide);
+
+    /**
+     * @brief number of iterations of the last solve()
+     */
+    int getIterations() const;
+
+    /**
+     * @brief whether the last solve() reached the tolerance
+     */
+    bool hasConverged() const;
+
+private:
+    const Communicator* communicator = nullptr;
+    const HaloExchange* haloExchange = nullptr;
+    double tolerance                 = Eigen::NumTraits<double>::epsilon(); ///< relative residual to reach
+    int iterations{};                                                       ///< iterations of the last solve()
+    bool converged = false;                                                 ///< whether the last solve() converged
+
+    /**
+     * @brief product of the own rows of the matrix and a vector of the own particles
+     */
+    Eigen::VectorXd
+    multiply(const Eigen::SparseMatrix<double, Eigen::RowMajor>& matrix, const Eigen::VectorXd& ownValues) const;
+
+    /**
+     * @brief dot product of two vectors of the own particles summed over the processes
+     */
+    double dot(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+};
+
+} // namespace Distributed
@@ -0,0 +1,124 @@
+#include "communicator.hpp"
+
+#include <algorithm>
+#include <mpi.h>
+
+using Distributed::Communicator;
+
+Communicator::Communicator() {
+    MPI_Comm_rank(MPI_COMM_WORLD, &ownRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numProcesses);
+}
+
+int Communicator::rank() const {
+    return ownRank;
+}
+
+int Communicator::size() const {
+    return numProcesses;
+}
+
+double Communicator::sum(const double value) const {
+    double result = 0.0;
+    MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    return result;
+}
+
+long long Communicator::sum(const long long value) const {
+    long long result = 0;
+    MPI_Allreduce(&value, &result, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    return result;
+}
+
+double Communicator::max(const double value) const {
+    double result = 0.0;
+    MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return result;
+}
+
+double Communicator::min(const double value) const {
+    double result = 0.0;
+    MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    return result;
+}
+
+std::vector<double> Communicator::sum(const std::vector<double>& values) const {
+    std::vector<double> result(values.size());
+    MPI_Allreduce(values.data(), result.data(), static_cast<int>(values.size()), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    return result;
+}
+
+std::vector<double> Communicator::allGather(const double value) const {
+    std::vector<double> values(numProcesses);
+    MPI_Allgather(&value, 1, MPI_DOUBLE, values.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+    return values;
+}
+
+void Communicator::barrier() const {
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+std::vector<std::vector<char>> Communicator::exchangeBytes(const std::vector<std::vector<char>>& sendBytes) const {
+    // The sizes are exchanged first so that each process can allocate the buffers to receive.
+    std::vector<int> sendCounts(numProcesses), receiveCounts(numProcesses);
+    for (int i = 0; i < numProcesses; i++) {
+        sendCounts[i] = static_cast<int>(sendBytes[i].size());
+    }
+    MPI_Alltoall(sendCounts.data(), 1, MPI_INT, receiveCounts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    std::vector<int> sendOffsets(numProcesses, 0), receiveOffsets(numProcesses, 0);
+    for (int i = 1; i < numProcesses; i++) {
+        sendOffsets[i]    = sendOffsets[i - 1] + sendCounts[i - 1];
+        receiveOffsets[i] = receiveOffsets[i - 1] + receiveCounts[i - 1];
+    }
+    std::vector<char> sendBuffer(sendOffsets.back() + sendCounts.back());
+    std::vector<char> receiveBuffer(receiveOffsets.back() + receiveCounts.back());
+    for (int i = 0; i < numProcesses; i++) {
+        std::copy(sendBytes[i].begin(), sendBytes[i].end(), sendBuffer.begin() + sendOffsets[i]);
+    }
+    MPI_Alltoallv(
+        sendBuffer.data(),
+        sendCounts.data(),
+        sendOffsets.data(),
+        MPI_BYTE,
+        receiveBuffer.data(),
+        receiveCounts.data(),
+        receiveOffsets.data(),
+        MPI_BYTE,
+        MPI_COMM_WORLD
+    );
+
+    std::vector<std::vector<char>> receivedBytes(numProcesses);
+    for (int i = 0; i < numProcesses; i++) {
+        auto begin = receiveBuffer.begin() + receiveOffsets[i];
+        receivedBytes[i].assign(begin, begin + receiveCounts[i]);
+    }
+    return receivedBytes;
+}
+
+std::vector<char> Communicator::gatherBytes(const std::vector<char>& bytes, const int root) const {
+    int count = static_cast<int>(bytes.size());
+    std::vector<int> counts(numProcesses);
+    MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, root, MPI_COMM_WORLD);
+
+    std::vector<int> offsets(numProcesses, 0);
+    for (int i = 1; i < numProcesses; i++) {
+        offsets[i] = offsets[i - 1] + counts[i - 1];
+    }
+    std::vector<char> gatheredBytes;
+    if (ownRank == root) {
+        gatheredBytes.resize(offsets.back() + counts.back());
+    }
+    MPI_Gatherv(
+        bytes.data(),
+        count,
+        MPI_BYTE,
+        gatheredBytes.data(),
+        counts.data(),
+        offsets.data(),
+        MPI_BYTE,
+        root,
+        MPI_COMM_WORLD
+    );
+    return gatheredBytes;
+}
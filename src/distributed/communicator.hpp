@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace Distributed {
+
+/**
+ * @brief Communication between the processes of the distributed mode
+ *
+ * @details A thin wrapper of MPI_COMM_WORLD, so that MPI is used only in this class. MPI has to be initialized before
+ * it is made. Values are exchanged as bytes, so the types exchanged have to be trivially copyable.
+ */
+class Communicator {
+public:
+    Communicator();
+
+    /**
+     * @brief rank of this process
+     */
+    int rank() const;
+
+    /**
+     * @brief number of processes
+     */
+    int size() const;
+
+    /**
+     * @brief sum of the values of all the processes
+     */
+    double sum(const double value) const;
+
+    /**
+     * @brief sum of the values of all the processes
+     */
+    long long sum(const long long value) const;
+
+    /**
+     * @brief maximum of the values of all the processes
+     */
+    double max(const double value) const;
+
+    /**
+     * @brief minimum of the values of all the processes
+     */
+    double min(const double value) const;
+
+    /**
+     * @brief element-wise sum of the vectors of all the processes, which have to be of the same size
+     */
+    std::vector<double> sum(const std::vector<double>& values) const;
+
+    /**
+     * @brief values of all the processes, in the order of their ranks
+     */
+    std::vector<double> allGather(const double value) const;
+
+    /**
+     * @brief wait until all the processes reach this call
+     */
+    void barrier() const;
+
+    /**
+     * @brief send values to each process and receive values from each process
+     * @param sendValues values to send to each process. The size has to be the number of processes.
+     * @return values received from each process
+     */
+    template <typename T> std::vector<std::vector<T>> exchange(const std::vector<std::vector<T>>& sendValues) const {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be exchanged");
+        std::vector<std::vector<char>> sendBytes(sendValues.size());
+        for (size_t i = 0; i < sendValues.size(); i++) {
+            sendBytes[i].resize(sendValues[i].size() * sizeof(T));
+            if (!sendValues[i].empty())
+                std::memcpy(sendBytes[i].data(), sendValues[i].data(), sendBytes[i].size());
+        }
+        auto receivedBytes = exchangeBytes(sendBytes);
+        std::vector<std::vector<T>> receivedValues(receivedBytes.size());
+        for (size_t i = 0; i < receivedBytes.size(); i++) {
+            receivedValues[i].resize(receivedBytes[i].size() / sizeof(T));
+            if (!receivedValues[i].empty())
+                std::memcpy(receivedValues[i].data(), receivedBytes[i].data(), receivedBytes[i].size());
+        }
+        return receivedValues;
+    }
+
+    /**
+     * @brief gather the values of all the processes to the root process
+     * @return values of all the processes in the order of their ranks in the root process, and nothing in the others
+     */
+    template <typename T> std::vector<T> gather(const std::vector<T>& values, const int root = 0) const {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be gathered");
+        std::vector<char> bytes(values.size() * sizeof(T));
+        if (!values.empty())
+            std::memcpy(bytes.data(), values.data(), bytes.size());
+        auto gatheredBytes = gatherBytes(bytes, root);
+        std::vector<T> gatheredValues(gatheredBytes.size() / sizeof(T));
+        if (!gatheredValues.empty())
+            std::memcpy(gatheredValues.data(), gatheredBytes.data(), gatheredBytes.size());
+        return gatheredValues;
+    }
+
+private:
+    int ownRank{};      ///< rank of this process
+    int numProcesses{}; ///< number of processes
+
+    std::vector<std::vector<char>> exchangeBytes(const std::vector<std::vector<char>>& sendBytes) const;
+    std::vector<char> gatherBytes(const std::vector<char>& bytes, const int root) const;
+};
+
+} // namespace Distributed
@@ -0,0 +1,99 @@
+#include "decomposition.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using Distributed::Decomposition;
+
+Decomposition::Decomposition(const int axis, const std::vector<double>& boundaries) {
+    this->axis       = axis;
+    this->boundaries = boundaries;
+}
+
+Decomposition Decomposition::balanced(const Particles& particles, const int numSlabs, const int dim) {
+    Eigen::Vector3d min = Eigen::Vector3d::Constant(std::numeric_limits<double>::max());
+    Eigen::Vector3d max = Eigen::Vector3d::Constant(std::numeric_limits<double>::lowest());
+    for (const auto& p : particles) {
+        if (p.type == ParticleType::Ghost)
+            continue;
+        min = min.cwiseMin(p.position);
+        max = max.cwiseMax(p.position);
+    }
+    Eigen::Vector3d extent = max - min;
+    int axis               = 0;
+    for (int i = 1; i < dim; i++) {
+        if (extent[i] > extent[axis])
+            axis = i;
+    }
+
+    std::vector<double> coordinates;
+    coordinates.reserve(particles.size());
+    for (const auto& p : particles) {
+        if (p.type != ParticleType::Ghost)
+            coordinates.push_back(p.position[axis]);
+    }
+    std::sort(coordinates.begin(), coordinates.end());
+
+    // The boundaries are at the quantiles of the coordinates. The particles on a boundary belong to the upper slab.
+    std::vector<double> boundaries;
+    for (int i = 1; i < numSlabs; i++) {
+        size_t index = coordinates.size() * i / numSlabs;
+        boundaries.push_back(coordinates.empty() ? 0.0 : coordinates[std::min(index, coordinates.size() - 1)]);
+    }
+    return Decomposition(axis, boundaries);
+}
+
+Decomposition Decomposition::fromWork(
+    const int axis, const double origin, const double binWidth, const std::vector<double>& work, const int numSlabs
+) {
+    double total = 0.0;
+    for (const auto& w : work) {
+        total += w;
+    }
+
+    std::vector<double> boundaries;
+    double cumulative = 0.0;
+    size_t bin        = 0;
+    for (int i = 1; i < numSlabs; i++) {
+        double target = total * i / numSlabs;
+        while (bin < work.size() && cumulative + work[bin] < target) {
+            cumulative += work[bin];
+            bin++;
+        }
+        double fraction = (bin < work.size() && work[bin] > 0.0) ? (target - cumulative) / work[bin] : 0.0;
+        boundaries.push_back(origin + binWidth * (static_cast<double>(bin) + fraction));
+    }
+    return Decomposition(axis, boundaries);
+}
+
+int Decomposition::rankOf(const Eigen::Vector3d& position) const {
+    return static_cast<int>(
+        std::upper_bound(boundaries.begin(), boundaries.end(), position[axis]) - boundaries.begin()
+    );
+}
+
+std::vector<int> Decomposition::haloRanks(const Eigen::Vector3d& position, const int rank, const double width) const {
+    std::vector<int> ranks;
+    double x = position[axis];
+    // the slabs below the own slab, until one of them is farther than the width
+    for (int r = rank - 1; r >= 0 && x - boundaries[r] < width; r--) {
+        ranks.push_back(r);
+    }
+    // the slabs above the own slab
+    for (int r = rank + 1; r < size() && boundaries[r - 1] - x < width; r++) {
+        ranks.push_back(r);
+    }
+    return ranks;
+}
+
+int Decomposition::size() const {
+    return static_cast<int>(boundaries.size()) + 1;
+}
+
+int Decomposition::getAxis() const {
+    return axis;
+}
+
+const std::vector<double>& Decomposition::getBoundaries() const {
+    return boundaries;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../particles.hpp"
+
+#include <Eigen/Dense>
+#include <vector>
+
+namespace Distributed {
+
+/**
+ * @brief Decomposition of the domain into slabs, one for each process
+ *
+ * @details The domain is cut by planes perpendicular to an axis. The slab of the process of rank r is
+ * [boundaries[r - 1], boundaries[r]) along the axis, where the first and the last slabs extend to infinity, so that
+ * every position belongs to exactly one process. It does not depend on MPI.
+ */
+class Decomposition {
+public:
+    Decomposition() = default;
+
+    /**
+     * @param axis axis perpendicular to the boundaries (0: x, 1: y, 2: z)
+     * @param boundaries coordinates of the boundaries between the slabs in ascending order. The number of slabs is
+     * one more than the number of boundaries.
+     */
+    Decomposition(const int axis, const std::vector<double>& boundaries);
+
+    /**
+     * @brief decompose so that each slab has the same number of particles
+     * @details The slabs are perpendicular to the axis along which the particles are spread the most, among the
+     * first dim axes. Ghost particles are not counted.
+     * @param particles particles to decompose
+     * @param numSlabs number of slabs, i.e. the number of processes
+     * @param dim dimension of the simulation
+     */
+    static Decomposition balanced(const Particles& particles, const int numSlabs, const int dim);
+
+    /**
+     * @brief decompose so that each slab has the same amount of work
+     * @details The boundaries are interpolated linearly within the bins, assuming that the work of a bin is spread
+     * uniformly over it.
+     * @param axis axis perpendicular to the boundaries
+     * @param origin coordinate of the lower end of the first bin
+     * @param binWidth width of each bin
+     * @param work work in each bin along the axis
+     * @param numSlabs number of slabs, i.e. the number of processes
+     */
+    static Decomposition fromWork(
+        const int axis, const double origin, const double binWidth, const std::vector<double>& work, const int numSlabs
+    );
+
+    /**
+     * @brief rank of the process the position belongs to
+     */
+    int rankOf(const Eigen::Vector3d& position) const;
+
+    /**
+     * @brief ranks of the other processes whose slabs are within the width from the position
+     * @details They are the processes that need a copy of the particle at the position as a halo particle.
+     * @param position position in the slab of the process of rank
+     * @param rank rank of the process the position belongs to
+     * @param width width of the halo
+     */
+    std::vector<int> haloRanks(const Eigen::Vector3d& position, const int rank, const double width) const;
+
+    /**
+     * @brief number of slabs
+     */
+    int size() const;
+
+    int getAxis() const;
+
+    const std::vector<double>& getBoundaries() const;
+
+private:
+    int axis = 0;                   ///< axis perpendicular to the boundaries
+    std::vector<double> boundaries; ///< coordinates of the boundaries between the slabs in ascending order
+};
+
+} // namespace Distributed
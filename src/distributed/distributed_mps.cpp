@@ -0,0 +1,133 @@
+#include "distributed_mps.hpp"
+
+#include "../mps_factory.hpp"
+#include "../pressure_calculator/dirichlet_boundary_condition_generator/free_surface.hpp"
+#include "implicit_pressure.hpp"
+
+using Distributed::DistributedMPS;
+using Distributed::HaloField;
+namespace DirichletBoundaryConditionGenerator = PressureCalculator::DirichletBoundaryConditionGenerator;
+
+DistributedMPS::DistributedMPS(const Communicator& communicator, const Input& input) {
+    // All the processes have loaded the same particles, so they make the same decomposition.
+    this->communicator  = &communicator;
+    this->mps           = MPSFactory::create(input);
+    this->decomposition = Decomposition::balanced(mps.particles, communicator.size(), input.settings.dim);
+    // The halo covers the radius of the neighbor search, including the skin.
+    this->haloExchange = HaloExchange(communicator, input.settings.reMax + input.settings.neighborSearchSkin);
+    haloExchange.distribute(mps.particles, decomposition);
+    mps.requestNeighborSearch();
+    this->loadBalancer = LoadBalancer(
+        communicator,
+        input.settings.loadBalanceInterval,
+        input.settings.loadBalanceThreshold,
+        0.5 * input.settings.particleDistance
+    );
+
+    // The explicit scheme needs no communication in the pressure calculation, so only the implicit one is replaced.
+    if (input.settings.pressureCalculationMethod == "Implicit") {
+        std::unique_ptr<DirichletBoundaryConditionGenerator::Interface> dirichletBoundaryConditionGenerator;
+        dirichletBoundaryConditionGenerator.reset(
+            new DirichletBoundaryConditionGenerator::FreeSurface(MPSFactory::createSurfaceDetector(input.settings))
+        );
+        mps.pressureCalculator.reset(new ImplicitPressure(
+            communicator,
+            haloExchange,
+            input.settings.dim,
+            input.settings.particleDistance,
+            input.settings.re_forNumberDensity,
+            input.settings.re_forLaplacian,
+            input.settings.dt,
+            input.settings.compressibility,
+            input.settings.relaxationCoefficientForPressure,
+            std::move(dirichletBoundaryConditionGenerator)
+        ));
+        mps.stages = mps.pressureCalculator->stepStages();
+    }
+}
+
+void DistributedMPS::stepForward() {
+    // The neighbor lists of the last search are still valid here, and the first stage of a time step is a neighbor
+    // search, which moves the particles to the owners of the new slabs.
+    loadBalancer.balance(mps.particles, haloExchange.getNumOwned(), decomposition, ++timeStep);
+
+    for (const auto& stage : mps.stages) {
+        if (stage == StepStage::SearchNeighbors || stage == StepStage::UpdateNeighbors) {
+            // The ids are renumbered by the rebuild, so the neighbor lists cannot be reused.
+            haloExchange.rebuild(mps.particles, decomposition);
+            mps.requestNeighborSearch();
+            staleFields.clear();
+            mps.runStage(stage);
+            continue;
+        }
+
+        std::vector<HaloField> fields;
+        for (const auto& field : readFields(stage)) {
+            if (staleFields.erase(field) > 0)
+                fields.push_back(field);
+        }
+        haloExchange.refresh(mps.particles, fields);
+        mps.runStage(stage);
+        for (const auto& field : writtenFields(stage)) {
+            staleFields.insert(field);
+        }
+    }
+
+    // The own particles that have left the domain are counted by the rebuild, and the halo ones by their owners.
+    mps.takeEscapedParticles();
+    mps.courant = communicator->max(mps.courant);
+}
+
+const MPS& DistributedMPS::getMPS() const {
+    return mps;
+}
+
+const Distributed::HaloExchange& DistributedMPS::getHaloExchange() const {
+    return haloExchange;
+}
+
+const Distributed::Decomposition& DistributedMPS::getDecomposition() const {
+    return decomposition;
+}
+
+const Distributed::LoadBalancer& DistributedMPS::getLoadBalancer() const {
+    return loadBalancer;
+}
+
+std::vector<HaloField> DistributedMPS::readFields(const StepStage& stage) {
+    switch (stage) {
+    case StepStage::Viscosity:
+    case StepStage::FusedPrediction:
+    case StepStage::Courant:
+        return {HaloField::Velocity};
+    case StepStage::Collision:
+    case StepStage::FusedCollision:
+        return {HaloField::Position, HaloField::Velocity};
+    case StepStage::Pressure:
+    case StepStage::UpdateNumberDensity:
+        return {HaloField::Position};
+    case StepStage::MinimumPressure:
+        return {HaloField::Pressure};
+    case StepStage::PressureGradient:
+    case StepStage::FusedCorrection:
+        return {HaloField::Position, HaloField::Pressure};
+    default:
+        return {};
+    }
+}
+
+std::vector<HaloField> DistributedMPS::writtenFields(const StepStage& stage) {
+    switch (stage) {
+    case StepStage::MoveParticle:
+    case StepStage::Collision:
+    case StepStage::MoveParticleUsingPressureGradient:
+    case StepStage::FusedPrediction:
+    case StepStage::FusedCollision:
+    case StepStage::FusedCorrection:
+        return {HaloField::Position, HaloField::Velocity};
+    case StepStage::Pressure:
+        return {HaloField::Pressure};
+    default:
+        return {};
+    }
+}
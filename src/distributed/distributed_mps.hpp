@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../input.hpp"
+#include "../mps.hpp"
+#include "../step_stage.hpp"
+#include "communicator.hpp"
+#include "decomposition.hpp"
+#include "halo_exchange.hpp"
+#include "load_balancer.hpp"
+
+#include <set>
+#include <vector>
+
+namespace Distributed {
+
+/**
+ * @brief MPS simulation of the distributed mode
+ *
+ * @details Each process runs the stages of MPS on the particles of its slab of the decomposition and their halo
+ * particles. Before each neighbor search, the particles that have left the slab are moved to their new owners and the
+ * halo particles are made again (see HaloExchange::rebuild()), so that the neighbor lists of the own particles are
+ * complete. Between the neighbor searches, the fields of the halo particles that a stage reads are sent again only if
+ * an earlier stage has updated them.
+ *
+ * The pressure Poisson equation of the implicit scheme is solved together with the other processes by
+ * ImplicitPressure. The boundaries of the slabs are moved by LoadBalancer at the beginning of a time step when the
+ * work of the processes is imbalanced.
+ */
+class DistributedMPS {
+public:
+    /**
+     * @param communicator communicator of the processes, which has to outlive this object
+     * @param input input loaded by all the processes
+     */
+    DistributedMPS(const Communicator& communicator, const Input& input);
+
+    DistributedMPS(const DistributedMPS&)            = delete;
+    DistributedMPS& operator=(const DistributedMPS&) = delete;
+
+    /**
+     * @brief advance the simulation by one time step
+     */
+    void stepForward();
+
+    /**
+     * @brief MPS of this process, whose particles are the own particles followed by the halo particles
+     * @details MPS::courant is the maximum among the particles of all the processes.
+     */
+    const MPS& getMPS() const;
+
+    const HaloExchange& getHaloExchange() const;
+
+    const Decomposition& getDecomposition() const;
+
+    const LoadBalancer& getLoadBalancer() const;
+
+private:
+    const Communicator* communicator = nullptr;
+    MPS mps;
+    Decomposition decomposition;
+    HaloExchange haloExchange;
+    LoadBalancer loadBalancer;
+    int timeStep{};                  ///< number of time steps advanced
+    std::set<HaloField> staleFields; ///< fields of the halo particles updated by their owners since they were sent
+
+    /**
+     * @brief fields of the neighbors that the stage reads
+     */
+    static std::vector<HaloField> readFields(const StepStage& stage);
+
+    /**
+     * @brief fields that the stage updates
+     */
+    static std::vector<HaloField> writtenFields(const StepStage& stage);
+};
+
+} // namespace Distributed
@@ -0,0 +1,138 @@
+#include "distributed_simulation.hpp"
+
+#include "../input.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+using Distributed::DistributedSimulation;
+using std::cout;
+using std::endl;
+namespace fs     = std::filesystem;
+namespace chrono = std::chrono;
+
+DistributedSimulation::DistributedSimulation(
+    const Communicator& communicator, const fs::path& settingPath, const fs::path& outputDirectory
+) {
+    this->communicator = &communicator;
+    bool isRoot        = communicator.rank() == 0;
+    Input input        = loader.load(settingPath, outputDirectory, false, isRoot);
+    if (isRoot) {
+        saver = Saver(outputDirectory, input.settings);
+    }
+
+    mps            = std::make_unique<DistributedMPS>(communicator, input);
+    startTime      = input.startTime;
+    time           = startTime;
+    endTime        = input.settings.endTime;
+    dt             = input.settings.dt;
+    outputPeriod   = input.settings.outputPeriod;
+    reportInterval = input.settings.reportInterval;
+
+    if (isRoot) {
+        const auto& decomposition = mps->getDecomposition();
+        cout << "Distributed over " << communicator.size() << " processes along axis " << decomposition.getAxis();
+        cout << " (boundaries:";
+        for (const auto& boundary : decomposition.getBoundaries()) {
+            cout << " " << boundary;
+        }
+        cout << ")" << endl;
+    }
+}
+
+void DistributedSimulation::run() {
+    if (communicator->rank() == 0) {
+        cout << endl;
+        cout << "*** START SIMULATION ***" << endl;
+    }
+    realStartTime = chrono::system_clock::now();
+    save();
+
+    while (time < endTime) {
+        auto timeStepStartTime = chrono::system_clock::now();
+
+        mps->stepForward();
+        timeStep++;
+        time += dt;
+
+        // the last time step is always reported
+        if (time >= endTime || (reportInterval > 0 && timeStep % reportInterval == 0)) {
+            timeStepReport(timeStepStartTime);
+        }
+        if (saveCondition()) {
+            save();
+        }
+    }
+    endSimulation();
+}
+
+void DistributedSimulation::save() {
+    // All the processes take part in the gathering, and only the first one writes the file.
+    MPS gathered;
+    gathered.particles = mps->getHaloExchange().gather(mps->getMPS().particles);
+    if (communicator->rank() == 0) {
+        gathered.refValuesForNumberDensity = mps->getMPS().refValuesForNumberDensity;
+        saver.save(gathered, time);
+    }
+    fileNumber++;
+}
+
+bool DistributedSimulation::saveCondition() const {
+    return time - startTime >= outputPeriod * double(fileNumber);
+}
+
+void DistributedSimulation::timeStepReport(const chrono::system_clock::time_point& timeStepStartTime) {
+    long long numParticles = communicator->sum(static_cast<long long>(mps->getHaloExchange().getNumOwned()));
+    if (communicator->rank() != 0)
+        return;
+
+    double last    = chrono::duration<double>(chrono::system_clock::now() - timeStepStartTime).count();
+    double elapsed = chrono::duration<double>(chrono::system_clock::now() - realStartTime).count();
+    printf(
+        "%d: dt=%.gs   t=%.3lfs   fin=%.1lfs   elapsed=%.1lfs   last=%.3lfs/step   out=%dfiles   particles=%lld   "
+        "iterations=%d   imbalance=%.2lf   Courant=%.2lf\n",
+        timeStep,
+        dt,
+        time,
+        endTime,
+        elapsed,
+        last,
+        fileNumber,
+        numParticles,
+        mps->getMPS().pressureCalculator->solverIterations(),
+        mps->getLoadBalancer().getImbalance(),
+        mps->getMPS().courant
+    );
+    fprintf(stderr, "%4d: t=%.3lfs\n", timeStep, time);
+}
+
+void DistributedSimulation::endSimulation() {
+    auto numOwned         = communicator->allGather(static_cast<double>(mps->getHaloExchange().getNumOwned()));
+    long long numEscaped  = communicator->sum(mps->getHaloExchange().getNumGhostsRemoved());
+    auto realEndTime      = chrono::system_clock::now();
+    double elapsedSeconds = chrono::duration<double>(realEndTime - realStartTime).count();
+    if (communicator->rank() != 0)
+        return;
+
+    saver.finish();
+    cout << endl;
+    if (numEscaped > 0) {
+        cout << numEscaped << " particles left the domain" << endl;
+    }
+    cout << "Particles of each process:";
+    for (const auto& n : numOwned) {
+        cout << " " << static_cast<long long>(n);
+    }
+    cout << endl;
+    const auto& loadBalancer = mps->getLoadBalancer();
+    printf(
+        "Load balancing: %d rebalances, imbalance %.2lf (last), %.2lf (max)\n",
+        loadBalancer.getNumRebalances(),
+        loadBalancer.getImbalance(),
+        loadBalancer.getMaxImbalance()
+    );
+    printf("Total Simulation time = %.3lfs\n", elapsedSeconds);
+
+    cout << endl;
+    cout << "*** END SIMULATION ***" << endl;
+}
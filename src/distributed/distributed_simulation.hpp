@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../loader.hpp"
+#include "../saver.hpp"
+#include "communicator.hpp"
+#include "distributed_mps.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+
+namespace Distributed {
+
+/**
+ * @brief Simulation process of the distributed mode
+ *
+ * @details The counterpart of Simulation for the processes started by mpirun. All the processes load the input, and
+ * the first one copies it to the output directory. The particles of all the processes are gathered to the first
+ * process, which writes the output files and reports the progress, so the output is the same as that of Simulation.
+ * Checkpoints are not written.
+ */
+class DistributedSimulation {
+public:
+    /**
+     * @param communicator communicator of the processes, which has to outlive this object
+     * @param settingPath path to the setting file
+     * @param outputDirectory path to the output directory
+     */
+    DistributedSimulation(
+        const Communicator& communicator,
+        const std::filesystem::path& settingPath,
+        const std::filesystem::path& outputDirectory
+    );
+
+    void run();
+
+private:
+    const Communicator* communicator = nullptr;
+    Loader loader;
+    Saver saver; ///< writes the output files (only in the first process)
+    std::unique_ptr<DistributedMPS> mps;
+
+    double startTime{}, time{}, endTime{}, dt{};
+    double outputPeriod{};
+    int timeStep       = 0;
+    int fileNumber     = 0; ///< number of the output files written, counted in all the processes
+    int reportInterval = 1; ///< number of time steps between progress reports
+    std::chrono::system_clock::time_point realStartTime;
+
+    /**
+     * @brief gather the particles to the first process and write them
+     */
+    void save();
+
+    bool saveCondition() const;
+
+    /**
+     * @brief report the time step, the number of particles, the imbalance and the courant number to the console
+     */
+    void timeStepReport(const std::chrono::system_clock::time_point& timeStepStartTime);
+
+    /**
+     * @brief report the total time and the number of particles of each process to the console
+     */
+    void endSimulation();
+};
+
+} // namespace Distributed
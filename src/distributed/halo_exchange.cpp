@@ -0,0 +1,201 @@
+#include "halo_exchange.hpp"
+
+#include <algorithm>
+
+using Distributed::HaloExchange;
+
+HaloExchange::HaloExchange(const Communicator& communicator, const double width) {
+    this->communicator = &communicator;
+    this->width        = width;
+}
+
+void HaloExchange::distribute(Particles& particles, const Decomposition& decomposition) {
+    Particles owned;
+    for (const auto& p : particles) {
+        if (p.type != ParticleType::Ghost && decomposition.rankOf(p.position) == communicator->rank()) {
+            owned.add(unpack(pack(p), owned.size()));
+        }
+    }
+    particles = std::move(owned);
+    numOwned  = particles.size();
+    makeHalo(particles, decomposition);
+}
+
+void HaloExchange::rebuild(Particles& particles, const Decomposition& decomposition) {
+    // The halo particles are not copied, since they are made again from the particles of their owners.
+    Particles owned;
+    owned.reserve(numOwned);
+    std::vector<std::vector<PackedParticle>> leaving(communicator->size());
+    for (int i = 0; i < numOwned; i++) {
+        const Particle& p = particles[i];
+        if (p.type == ParticleType::Ghost) {
+            numGhostsRemoved++;
+            continue;
+        }
+        int rank = decomposition.rankOf(p.position);
+        if (rank == communicator->rank()) {
+            owned.add(unpack(pack(p), owned.size()));
+        } else {
+            leaving[rank].push_back(pack(p));
+        }
+    }
+
+    auto arriving = communicator->exchange(leaving);
+    for (const auto& packedParticles : arriving) {
+        for (const auto& packed : packedParticles) {
+            owned.add(unpack(packed, owned.size()));
+        }
+    }
+    particles = std::move(owned);
+    numOwned  = particles.size();
+    makeHalo(particles, decomposition);
+}
+
+void HaloExchange::makeHalo(Particles& particles, const Decomposition& decomposition) {
+    sendIds.assign(communicator->size(), {});
+    std::vector<std::vector<PackedParticle>> halo(communicator->size());
+    for (int i = 0; i < numOwned; i++) {
+        for (const auto& rank : decomposition.haloRanks(particles[i].position, communicator->rank(), width)) {
+            sendIds[rank].push_back(i);
+            halo[rank].push_back(pack(particles[i]));
+        }
+    }
+
+    auto received = communicator->exchange(halo);
+    receiveOffsets.assign(communicator->size(), 0);
+    receiveCounts.assign(communicator->size(), 0);
+    for (int rank = 0; rank < communicator->size(); rank++) {
+        receiveOffsets[rank] = particles.size();
+        receiveCounts[rank]  = static_cast<int>(received[rank].size());
+        for (const auto& packed : received[rank]) {
+            particles.add(unpack(packed, particles.size()));
+        }
+    }
+}
+
+void HaloExchange::refresh(Particles& particles, const std::vector<HaloField>& fields) const {
+    if (fields.empty())
+        return;
+
+    std::vector<std::vector<double>> sendValues(communicator->size());
+    for (int rank = 0; rank < communicator->size(); rank++) {
+        for (const auto& id : sendIds[rank]) {
+            const Particle& p = particles[id];
+            for (const auto& field : fields) {
+                switch (field) {
+                case HaloField::Position:
+                    sendValues[rank].insert(sendValues[rank].end(), p.position.data(), p.position.data() + 3);
+                    break;
+                case HaloField::Velocity:
+                    sendValues[rank].insert(sendValues[rank].end(), p.velocity.data(), p.velocity.data() + 3);
+                    break;
+                case HaloField::Pressure:
+                    sendValues[rank].push_back(p.pressure);
+                    break;
+                }
+            }
+        }
+    }
+
+    // The values are received in the same order as they were sent, since the ids to send do not change between the
+    // calls of rebuild().
+    auto receivedValues = communicator->exchange(sendValues);
+    for (int rank = 0; rank < communicator->size(); rank++) {
+        const double* value = receivedValues[rank].data();
+        for (int i = 0; i < receiveCounts[rank]; i++) {
+            Particle& p = particles[receiveOffsets[rank] + i];
+            for (const auto& field : fields) {
+                switch (field) {
+                case HaloField::Position:
+                    p.position = Eigen::Vector3d(value[0], value[1], value[2]);
+                    value += 3;
+                    break;
+                case HaloField::Velocity:
+                    p.velocity = Eigen::Vector3d(value[0], value[1], value[2]);
+                    value += 3;
+                    break;
+                case HaloField::Pressure:
+                    p.pressure = *value++;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void HaloExchange::refresh(Eigen::VectorXd& values) const {
+    std::vector<std::vector<double>> sendValues(communicator->size());
+    for (int rank = 0; rank < communicator->size(); rank++) {
+        for (const auto& id : sendIds[rank]) {
+            sendValues[rank].push_back(values[id]);
+        }
+    }
+
+    auto receivedValues = communicator->exchange(sendValues);
+    for (int rank = 0; rank < communicator->size(); rank++) {
+        for (int i = 0; i < receiveCounts[rank]; i++) {
+            values[receiveOffsets[rank] + i] = receivedValues[rank][i];
+        }
+    }
+}
+
+Particles HaloExchange::gather(const Particles& particles, const int root) const {
+    std::vector<PackedParticle> own;
+    own.reserve(numOwned);
+    for (int i = 0; i < numOwned; i++) {
+        own.push_back(pack(particles[i]));
+    }
+    auto gathered = communicator->gather(own, root);
+    std::sort(gathered.begin(), gathered.end(), [](const PackedParticle& a, const PackedParticle& b) {
+        return a.originalId < b.originalId;
+    });
+
+    Particles result;
+    result.reserve(gathered.size());
+    for (const auto& packed : gathered) {
+        result.add(unpack(packed, result.size()));
+    }
+    return result;
+}
+
+int HaloExchange::getNumOwned() const {
+    return numOwned;
+}
+
+long long HaloExchange::getNumGhostsRemoved() const {
+    return numGhostsRemoved;
+}
+
+HaloExchange::PackedParticle HaloExchange::pack(const Particle& particle) {
+    PackedParticle packed;
+    packed.originalId        = particle.originalId;
+    packed.fluidType         = particle.fluidType;
+    packed.type              = particle.type;
+    packed.boundaryCondition = particle.boundaryCondition;
+    for (int i = 0; i < 3; i++) {
+        packed.position[i]     = particle.position[i];
+        packed.velocity[i]     = particle.velocity[i];
+        packed.acceleration[i] = particle.acceleration[i];
+    }
+    packed.pressure        = particle.pressure;
+    packed.numberDensity   = particle.numberDensity;
+    packed.density         = particle.density;
+    packed.sourceTerm      = particle.sourceTerm;
+    packed.minimumPressure = particle.minimumPressure;
+    return packed;
+}
+
+Particle HaloExchange::unpack(const PackedParticle& packed, const int id) {
+    Eigen::Vector3d position(packed.position[0], packed.position[1], packed.position[2]);
+    Eigen::Vector3d velocity(packed.velocity[0], packed.velocity[1], packed.velocity[2]);
+    Eigen::Vector3d acceleration(packed.acceleration[0], packed.acceleration[1], packed.acceleration[2]);
+    Particle particle(id, packed.type, position, velocity, packed.density, packed.fluidType);
+    particle.originalId        = packed.originalId;
+    particle.boundaryCondition = packed.boundaryCondition;
+    particle.acceleration      = acceleration;
+    particle.pressure          = packed.pressure;
+    particle.numberDensity     = packed.numberDensity;
+    particle.sourceTerm        = packed.sourceTerm;
+    particle.minimumPressure   = packed.minimumPressure;
+    return particle;
+}
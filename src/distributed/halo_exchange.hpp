@@ -0,0 +1,121 @@
+#pragma once
+
+#include "../particles.hpp"
+#include "communicator.hpp"
+#include "decomposition.hpp"
+
+#include <Eigen/Dense>
+#include <vector>
+
+namespace Distributed {
+
+/**
+ * @brief Field of halo particles that is sent again when their owners have updated it
+ */
+enum class HaloField {
+    Position, ///< position
+    Velocity, ///< velocity
+    Pressure, ///< pressure
+};
+
+/**
+ * @brief Exchange of particles between the processes of the distributed mode
+ *
+ * @details Each process owns the particles in its slab of the decomposition. They are stored at the beginning of the
+ * particles of the process, followed by the halo particles, which are copies of the particles of the other processes
+ * within the halo width from the slab. The halo particles are used as neighbors of the own particles, so the width has
+ * to be at least the radius of the neighbor search.
+ *
+ * rebuild() moves the particles that have left the slab to their new owners and makes the halo particles again, which
+ * invalidates the ids. refresh() sends the updated fields of the same halo particles without changing the ids.
+ */
+class HaloExchange {
+public:
+    HaloExchange() = default;
+
+    /**
+     * @param communicator communicator of the processes, which has to outlive this object
+     * @param width width of the halo
+     */
+    HaloExchange(const Communicator& communicator, const double width);
+
+    /**
+     * @brief keep only the particles of the own slab, e.g. when all the processes have loaded the same particles
+     * @details The halo particles are made as well.
+     */
+    void distribute(Particles& particles, const Decomposition& decomposition);
+
+    /**
+     * @brief move the own particles that have left the slab to their owners and make the halo particles again
+     * @details The halo particles are removed first, and the own ghost particles are removed as well. The ids of the
+     * particles are renumbered and the neighbor lists are cleared, so neighbors have to be searched again.
+     */
+    void rebuild(Particles& particles, const Decomposition& decomposition);
+
+    /**
+     * @brief send the fields of the own particles to the halo particles of the other processes
+     * @param particles particles made by rebuild()
+     * @param fields fields to send
+     */
+    void refresh(Particles& particles, const std::vector<HaloField>& fields) const;
+
+    /**
+     * @brief send the values of the own particles to the halo particles of the other processes
+     * @param values values of the particles made by rebuild(), e.g. the solution of a linear system
+     */
+    void refresh(Eigen::VectorXd& values) const;
+
+    /**
+     * @brief gather the own particles of all the processes to the root process, e.g. to write them to a file
+     * @return particles of all the processes in the order of their original ids in the root process, and nothing in
+     * the others
+     */
+    Particles gather(const Particles& particles, const int root = 0) const;
+
+    /**
+     * @brief number of the own particles, which are stored before the halo particles
+     */
+    int getNumOwned() const;
+
+    /**
+     * @brief number of the own ghost particles removed by rebuild() so far
+     */
+    long long getNumGhostsRemoved() const;
+
+private:
+    /**
+     * @brief particle sent to another process, with the fields needed to continue the time step there
+     */
+    struct PackedParticle {
+        int originalId;
+        int fluidType;
+        ParticleType type;
+        FluidState boundaryCondition;
+        double position[3];
+        double velocity[3];
+        double acceleration[3];
+        double pressure;
+        double numberDensity;
+        double density;
+        double sourceTerm;
+        double minimumPressure;
+    };
+
+    const Communicator* communicator = nullptr;
+    double width{};
+    int numOwned{};
+    long long numGhostsRemoved{};
+    std::vector<std::vector<int>> sendIds; ///< ids of the own particles sent as halo particles to each process
+    std::vector<int> receiveOffsets;       ///< id of the first halo particle received from each process
+    std::vector<int> receiveCounts;        ///< number of the halo particles received from each process
+
+    /**
+     * @brief make the halo particles of the own particles and append them to the particles
+     */
+    void makeHalo(Particles& particles, const Decomposition& decomposition);
+
+    static PackedParticle pack(const Particle& particle);
+    static Particle unpack(const PackedParticle& packed, const int id);
+};
+
+} // namespace Distributed
@@ -0,0 +1,72 @@
+#include "implicit_pressure.hpp"
+
+#include "../pressure_calculator/implicit.hpp"
+#include "../refvalues.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+using Distributed::ImplicitPressure;
+using std::cerr;
+using std::endl;
+
+ImplicitPressure::ImplicitPressure(
+    const Communicator& communicator,
+    const HaloExchange& haloExchange,
+    int dimension,
+    double particleDistance,
+    double reForNumberDensity,
+    double reForLaplacian,
+    double dt,
+    double compressibility,
+    double relaxationCoefficient,
+    std::unique_ptr<PressureCalculator::DirichletBoundaryConditionGenerator::Interface>&&
+        dirichletBoundaryConditionGenerator
+) {
+    auto refValuesForNumberDensity            = RefValues(dimension, particleDistance, reForNumberDensity);
+    auto refValuesForLaplacian                = RefValues(dimension, particleDistance, reForLaplacian);
+    this->haloExchange                        = &haloExchange;
+    this->dirichletBoundaryConditionGenerator = std::move(dirichletBoundaryConditionGenerator);
+    this->solver                              = BiCGSTAB(communicator, haloExchange);
+    this->pressurePoissonEquation             = PressureCalculator::PressurePoissonEquation(
+        dimension,
+        dt,
+        relaxationCoefficient,
+        compressibility,
+        refValuesForNumberDensity.n0,
+        refValuesForLaplacian.n0,
+        refValuesForLaplacian.lambda,
+        reForLaplacian,
+        reForNumberDensity
+    );
+}
+
+std::vector<double> ImplicitPressure::calc(Particles& particles) {
+    // The boundary conditions of the halo particles may differ from those of their owners since some of their
+    // neighbors are missing, but only whether they are ignored is used in the rows of the own particles, which depends
+    // only on the particle type.
+    auto dirichletBoundaryCondition = dirichletBoundaryConditionGenerator->generate(particles);
+    pressurePoissonEquation.setup(particles, dirichletBoundaryCondition);
+    int numOwned                = haloExchange->getNumOwned();
+    Eigen::VectorXd sourceTerm  = pressurePoissonEquation.getSourceTerm().head(numOwned);
+    Eigen::VectorXd ownPressure = solver.solve(pressurePoissonEquation.getCoefficientMatrix(), sourceTerm);
+    if (!solver.hasConverged()) {
+        cerr << "Pressure calculation failed." << endl;
+        std::exit(-1);
+    }
+
+    // negative pressure is removed for stability as in PressureCalculator::Implicit
+    std::vector<double> pressure(particles.size(), 0.0);
+    for (int i = 0; i < numOwned; i++) {
+        pressure[i] = std::max(ownPressure[i], 0.0);
+    }
+    return pressure;
+}
+
+std::vector<StepStage> ImplicitPressure::stepStages() const {
+    return PressureCalculator::Implicit::stages();
+}
+
+int ImplicitPressure::solverIterations() const {
+    return solver.getIterations();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../particles.hpp"
+#include "../pressure_calculator/dirichlet_boundary_condition_generator/interface.hpp"
+#include "../pressure_calculator/interface.hpp"
+#include "../pressure_calculator/pressure_poisson_equation.hpp"
+#include "bicgstab.hpp"
+#include "communicator.hpp"
+#include "halo_exchange.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace Distributed {
+
+/**
+ * @brief Implicit pressure calculation of the distributed mode
+ *
+ * @details The same as PressureCalculator::Implicit, except that the pressure Poisson equation of the own particles is
+ * solved together with the other processes by BiCGSTAB. The equation is set up for the own and the halo particles, and
+ * the rows of the own particles are used.
+ */
+class ImplicitPressure : public PressureCalculator::Interface {
+public:
+    /**
+     * @param communicator communicator of the processes, which has to outlive this object
+     * @param haloExchange exchange of the halo particles, which has to outlive this object
+     */
+    ImplicitPressure(
+        const Communicator& communicator,
+        const HaloExchange& haloExchange,
+        int dimension,
+        double particleDistance,
+        double reForNumberDensity,
+        double reForLaplacian,
+        double dt,
+        double compressibility,
+        double relaxationCoefficient,
+        std::unique_ptr<PressureCalculator::DirichletBoundaryConditionGenerator::Interface>&&
+            dirichletBoundaryConditionGenerator
+    );
+
+    /**
+     * @brief calculate pressure of the own particles
+     * @return pressures of the own particles, and 0 for the halo particles
+     */
+    std::vector<double> calc(Particles& particles) override;
+    std::vector<StepStage> stepStages() const override;
+    int solverIterations() const override;
+
+private:
+    const HaloExchange* haloExchange = nullptr;
+    std::unique_ptr<PressureCalculator::DirichletBoundaryConditionGenerator::Interface>
+        dirichletBoundaryConditionGenerator;
+    PressureCalculator::PressurePoissonEquation pressurePoissonEquation;
+    BiCGSTAB solver;
+};
+
+} // namespace Distributed
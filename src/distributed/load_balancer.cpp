@@ -0,0 +1,77 @@
+#include "load_balancer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using Distributed::LoadBalancer;
+
+LoadBalancer::LoadBalancer(
+    const Communicator& communicator, const int interval, const double threshold, const double binWidth
+) {
+    this->communicator = &communicator;
+    this->interval     = interval;
+    this->threshold    = threshold;
+    this->binWidth     = binWidth;
+}
+
+bool LoadBalancer::balance(
+    const Particles& particles, const int numOwned, Decomposition& decomposition, const int timeStep
+) {
+    if (interval <= 0 || timeStep % interval != 0 || communicator->size() == 1)
+        return false;
+
+    int axis       = decomposition.getAxis();
+    double ownWork = 0.0;
+    double ownMin  = std::numeric_limits<double>::max();
+    double ownMax  = std::numeric_limits<double>::lowest();
+    for (int i = 0; i < numOwned; i++) {
+        const Particle& p = particles[i];
+        if (p.type == ParticleType::Ghost)
+            continue;
+        ownWork += workOf(p);
+        ownMin = std::min(ownMin, p.position[axis]);
+        ownMax = std::max(ownMax, p.position[axis]);
+    }
+
+    double maxWork  = communicator->max(ownWork);
+    double meanWork = communicator->sum(ownWork) / communicator->size();
+    imbalance       = meanWork > 0.0 ? maxWork / meanWork - 1.0 : 0.0;
+    maxImbalance    = std::max(maxImbalance, imbalance);
+    if (imbalance <= threshold)
+        return false;
+
+    // The histogram covers the own particles of all the processes, so that every process makes the same boundaries.
+    double min  = communicator->min(ownMin);
+    double max  = communicator->max(ownMax);
+    int numBins = static_cast<int>(std::floor((max - min) / binWidth)) + 1;
+    std::vector<double> work(numBins, 0.0);
+    for (int i = 0; i < numOwned; i++) {
+        const Particle& p = particles[i];
+        if (p.type == ParticleType::Ghost)
+            continue;
+        int bin = std::clamp(static_cast<int>((p.position[axis] - min) / binWidth), 0, numBins - 1);
+        work[bin] += workOf(p);
+    }
+    work = communicator->sum(work);
+
+    decomposition = Decomposition::fromWork(axis, min, binWidth, work, communicator->size());
+    numRebalances++;
+    return true;
+}
+
+double LoadBalancer::getImbalance() const {
+    return imbalance;
+}
+
+double LoadBalancer::getMaxImbalance() const {
+    return maxImbalance;
+}
+
+int LoadBalancer::getNumRebalances() const {
+    return numRebalances;
+}
+
+double LoadBalancer::workOf(const Particle& particle) {
+    return 1.0 + static_cast<double>(particle.neighbors.size());
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../particles.hpp"
+#include "communicator.hpp"
+#include "decomposition.hpp"
+
+namespace Distributed {
+
+/**
+ * @brief Dynamic load balancing of the slabs of the distributed mode
+ *
+ * @details The work of each process is measured every interval time steps as the sum of the work of its own particles,
+ * each of which is one plus the number of its neighbors, since the loops over the neighbors dominate the time step.
+ * When the imbalance exceeds the threshold, the boundaries are moved so that each slab has the same amount of work,
+ * using a histogram of the work along the axis summed over the processes. The particles are moved to their new owners
+ * at the next HaloExchange::rebuild().
+ *
+ * The threshold gives hysteresis: a slightly imbalanced decomposition is kept, so that the boundaries do not move back
+ * and forth with the noise of the work.
+ */
+class LoadBalancer {
+public:
+    LoadBalancer() = default;
+
+    /**
+     * @param communicator communicator of the processes, which has to outlive this object
+     * @param interval number of time steps between the measurements (0: never balanced)
+     * @param threshold imbalance above which the boundaries are moved
+     * @param binWidth width of the bins of the histogram of the work, i.e. the resolution of the boundaries
+     */
+    LoadBalancer(const Communicator& communicator, const int interval, const double threshold, const double binWidth);
+
+    /**
+     * @brief measure the imbalance and move the boundaries if it is due and the imbalance exceeds the threshold
+     * @param particles own particles followed by the halo particles, with the neighbor lists of the own particles
+     * @param numOwned number of the own particles
+     * @param decomposition decomposition to move the boundaries of
+     * @param timeStep current time step, which decides whether it is due
+     * @return whether the boundaries have been moved
+     */
+    bool balance(const Particles& particles, const int numOwned, Decomposition& decomposition, const int timeStep);
+
+    /**
+     * @brief imbalance of the last measurement
+     * @details The maximum work of the processes divided by the mean minus one, i.e. 0 when perfectly balanced.
+     */
+    double getImbalance() const;
+
+    /**
+     * @brief maximum imbalance measured so far
+     */
+    double getMaxImbalance() const;
+
+    /**
+     * @brief number of times the boundaries have been moved
+     */
+    int getNumRebalances() const;
+
+private:
+    const Communicator* communicator = nullptr;
+    int interval{};
+    double threshold{};
+    double binWidth{};
+    double imbalance{};
+    double maxImbalance{};
+    int numRebalances{};
+
+    static double workOf(const Particle& particle);
+};
+
+} // namespace Distributed
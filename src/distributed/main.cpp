@@ -0,0 +1,59 @@
+#include "../common.hpp"
+#include "communicator.hpp"
+#include "distributed_simulation.hpp"
+
+#include <argparse/argparse.hpp>
+#include <filesystem>
+#include <mpi.h>
+
+using std::cerr;
+using std::endl;
+namespace fs = std::filesystem;
+
+/**
+ * @brief entry point of the distributed mode, which is started by mpirun
+ *
+ * @param argc number of arguments
+ * @param argv array of arguments
+ * @return return code
+ */
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+
+    argparse::ArgumentParser program("mps_mpi");
+
+    program.add_argument("-s", "--setting").required().help("path to setting file");
+    program.add_argument("-o", "--output").required().help("path to output directory");
+
+    // Although the use of exeptions is prohibited by the guidelines of this project,
+    // the following process is shown in the document of the argpase library,
+    // so we use here as an execptional calse.
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception& err) {
+        cerr << err.what() << endl;
+        cerr << program;
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    auto settingPath     = fs::path(program.get<std::string>("--setting"));
+    auto outputDirectory = fs::path(program.get<std::string>("--output"));
+    if (!fs::exists(settingPath)) {
+        cerr << "ERROR: The setting file " << settingPath << " does not exist" << endl;
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+    if (!fs::exists(outputDirectory)) {
+        cerr << "ERROR: The output directory " << outputDirectory << " does not exist" << endl;
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    {
+        // destroyed before MPI is finalized
+        Distributed::Communicator communicator;
+        Distributed::DistributedSimulation simulation(communicator, settingPath, outputDirectory);
+        simulation.run();
+    }
+
+    MPI_Finalize();
+    return 0;
+}
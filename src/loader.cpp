@@ -6,6 +6,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <map>
 #include <yaml-cpp/yaml.h>
 
 using std::cerr;
@@ -14,10 +15,16 @@ using std::endl;
 
 namespace fs = std::filesystem;
 
-Input Loader::load(const fs::path& settingPath, const fs::path& outputDirectory) {
+Input Loader::load(
+    const fs::path& settingPath, const fs::path& outputDirectory, bool isRestart, bool copiesInputFiles
+) {
     Input input;
 
     input.settings = loadSettingYaml(settingPath);
+    if (isRestart) {
+        copyInputFileToOutputDirectory(settingPath, outputDirectory, true);
+        return input;
+    }
 
     auto particlesPath          = input.settings.particlesPath;
     this->particlesLoader       = getParticlesLoader(particlesPath);
@@ -25,8 +32,10 @@ Input Loader::load(const fs::path& settingPath, const fs::path& outputDirectory)
     input.startTime             = startTime;
     input.particles             = particles;
 
-    copyInputFileToOutputDirectory(settingPath, outputDirectory);
-    copyInputFileToOutputDirectory(particlesPath, outputDirectory);
+    if (copiesInputFiles) {
+        copyInputFileToOutputDirectory(settingPath, outputDirectory);
+        copyInputFileToOutputDirectory(particlesPath, outputDirectory);
+    }
 
     return input;
 }
@@ -55,11 +64,19 @@ std::unique_ptr<ParticlesLoader::Interface> Loader::getParticlesLoader(const fs:
  * @brief Copy the input file to the output directory
  * @param inputFilePath Path to the input file
  * @param outputDirectory Path to the output directory
- * @warning If the file already exists in the output directory, the program will exit.
+ * @param overwrites If true, the file in the output directory is overwritten
+ * @warning If the file already exists in the output directory and overwrites is false, the program will exit.
  */
-void Loader::copyInputFileToOutputDirectory(const fs::path& inputFilePath, const fs::path& outputDirectory) {
+void Loader::copyInputFileToOutputDirectory(
+    const fs::path& inputFilePath, const fs::path& outputDirectory, bool overwrites
+) {
     auto outputFilePath = outputDirectory / inputFilePath.filename();
-    if (fs::exists(outputFilePath)) {
+    if (overwrites) {
+        // copying a file onto itself is not allowed
+        if (!fs::exists(outputFilePath) || !fs::equivalent(inputFilePath, outputFilePath)) {
+            fs::copy_file(inputFilePath, outputFilePath, fs::copy_options::overwrite_existing);
+        }
+    } else if (fs::exists(outputFilePath)) {
         cerr << "file " << outputFilePath << " already exists in the output directory" << endl;
         std::exit(-1);
     } else {
@@ -106,6 +123,10 @@ Settings Loader::loadSettingYaml(const fs::path& settingPath) {
     s.relaxationCoefficientForPressure = yaml["relaxationCoefficientForPressure"].as<double>();
     // for Explicit
     s.soundSpeed = yaml["soundSpeed"].as<double>();
+    // check if fuseExplicitStages is defined in the yaml file since it is optional
+    if (yaml["fuseExplicitStages"]) {
+        s.fuseExplicitStages = yaml["fuseExplicitStages"].as<bool>();
+    }
 
     // collision
     s.collisionDistance        = yaml["collisionDistanceRatio"].as<double>() * s.particleDistance;
@@ -117,6 +138,50 @@ Settings Loader::loadSettingYaml(const fs::path& settingPath) {
     s.re_forLaplacian     = yaml["radiusRatioForLaplacian"].as<double>() * s.particleDistance;
     s.reMax               = std::max({s.re_forNumberDensity, s.re_forGradient, s.re_forLaplacian});
 
+    // neighbor search (optional)
+    // Substepping: neighbors are searched every neighborSearchInterval steps with an extra radius (skin) so that the
+    // neighbor lists stay valid in between.
+    if (yaml["neighborSearchInterval"]) {
+        s.neighborSearchInterval = yaml["neighborSearchInterval"].as<int>();
+    }
+    if (s.neighborSearchInterval > 1) {
+        if (s.pressureCalculationMethod != "Explicit" || !s.fuseExplicitStages) {
+            cerr << "neighborSearchInterval > 1 is only supported with the fused stages of Explicit method." << endl;
+            std::exit(-1);
+        }
+        double skinRatio     = yaml["neighborSearchSkinRatio"] ? yaml["neighborSearchSkinRatio"].as<double>() : 0.2;
+        s.neighborSearchSkin = skinRatio * s.particleDistance;
+    }
+
+    // neighborSearchBucket
+    // check if neighborSearchBucket is defined in the yaml file since it is optional
+    if (yaml["neighborSearchBucket"]) {
+        auto bucketType = yaml["neighborSearchBucket"].as<std::string>();
+        if (bucketType != "dense" && bucketType != "sparse") {
+            cerr << "Invalid neighborSearchBucket: " << bucketType << ". It should be dense or sparse." << endl;
+            std::exit(-1);
+        }
+        s.sparseBucket = (bucketType == "sparse");
+    }
+
+    // tileCells
+    // check if tileCells is defined in the yaml file since it is optional
+    if (yaml["tileCells"]) {
+        s.tileCells = yaml["tileCells"].as<int>();
+        if (s.tileCells < 1) {
+            cerr << "Invalid tileCells: " << s.tileCells << ". It should be positive." << endl;
+            std::exit(-1);
+        }
+    }
+
+    // ghost particles (optional)
+    if (yaml["ghostCompactionInterval"]) {
+        s.ghostCompactionInterval = yaml["ghostCompactionInterval"].as<int>();
+    }
+    if (yaml["ghostLog"]) {
+        s.ghostLog = yaml["ghostLog"].as<bool>();
+    }
+
     // domain
     s.domain.xMin    = yaml["domainMin"][0].as<double>();
     s.domain.xMax    = yaml["domainMax"][0].as<double>();
@@ -140,5 +205,157 @@ Settings Loader::loadSettingYaml(const fs::path& settingPath) {
     } else {
         s.outputVtkInBinary = false;
     }
+
+    // outputVtkCompression
+    // check if outputVtkCompression is defined in the yaml file since it is optional
+    if (yaml["outputVtkCompression"]) {
+        auto compression = yaml["outputVtkCompression"].as<std::string>();
+        if (compression != "none" && compression != "zlib") {
+            cerr << "Invalid outputVtkCompression: " << compression << ". It should be none or zlib." << endl;
+            std::exit(-1);
+        }
+        s.outputVtkCompressed = (compression == "zlib");
+    }
+
+    // outputVtkCells
+    // check if outputVtkCells is defined in the yaml file since it is optional
+    if (yaml["outputVtkCells"]) {
+        s.outputVtkCells = yaml["outputVtkCells"].as<bool>();
+    }
+
+    // asyncOutput
+    // check if asyncOutput is defined in the yaml file since it is optional
+    if (yaml["asyncOutput"]) {
+        s.asyncOutput = yaml["asyncOutput"].as<bool>();
+    }
+
+    // outputFormats
+    // check if outputFormats is defined in the yaml file since it is optional
+    if (yaml["outputFormats"]) {
+        s.outputFormats = yaml["outputFormats"].as<std::vector<std::string>>();
+        for (const auto& format : s.outputFormats) {
+            if (format != "prof" && format != "vtu" && format != "csv" && format != "series") {
+                cerr << "Invalid output format: " << format << ". It should be prof, vtu, csv or series." << endl;
+                std::exit(-1);
+            }
+        }
+    }
+
+    // outputFields
+    // check if outputFields is defined in the yaml file since it is optional
+    if (yaml["outputFields"]) {
+        const std::map<std::string, ParticleField> fieldNames = {
+            {"type", ParticleField::Type},
+            {"velocity", ParticleField::Velocity},
+            {"pressure", ParticleField::Pressure},
+            {"numberDensity", ParticleField::NumberDensity},
+            {"boundaryCondition", ParticleField::BoundaryCondition},
+            {"fluidType", ParticleField::FluidType},
+            {"originalId", ParticleField::OriginalId},
+        };
+        s.outputFields.clear();
+        for (const auto& name : yaml["outputFields"].as<std::vector<std::string>>()) {
+            if (fieldNames.count(name) == 0) {
+                cerr << "Invalid output field: " << name << ". It should be one of type, velocity, pressure, "
+                     << "numberDensity, boundaryCondition, fluidType and originalId." << endl;
+                std::exit(-1);
+            }
+            s.outputFields.push_back(fieldNames.at(name));
+        }
+    }
+
+    // checkpointAtEnd
+    // check if checkpointAtEnd is defined in the yaml file since it is optional
+    if (yaml["checkpointAtEnd"]) {
+        s.checkpointAtEnd = yaml["checkpointAtEnd"].as<bool>();
+    }
+
+    // checkpointInterval
+    // check if checkpointInterval is defined in the yaml file since it is optional
+    if (yaml["checkpointInterval"]) {
+        s.checkpointInterval = yaml["checkpointInterval"].as<int>();
+        if (s.checkpointInterval < 0) {
+            cerr << "Invalid checkpointInterval: " << s.checkpointInterval << ". It should be 0 or positive." << endl;
+            std::exit(-1);
+        }
+    }
+
+    // checkpointWallMinutes
+    // check if checkpointWallMinutes is defined in the yaml file since it is optional
+    if (yaml["checkpointWallMinutes"]) {
+        s.checkpointWallMinutes = yaml["checkpointWallMinutes"].as<double>();
+        if (s.checkpointWallMinutes < 0.0) {
+            cerr << "Invalid checkpointWallMinutes: " << s.checkpointWallMinutes << ". It should be 0 or positive."
+                 << endl;
+            std::exit(-1);
+        }
+    }
+
+    // checkpointsKept
+    // check if checkpointsKept is defined in the yaml file since it is optional
+    if (yaml["checkpointsKept"]) {
+        s.checkpointsKept = yaml["checkpointsKept"].as<int>();
+        if (s.checkpointsKept < 0) {
+            cerr << "Invalid checkpointsKept: " << s.checkpointsKept << ". It should be 0 or positive." << endl;
+            std::exit(-1);
+        }
+    }
+
+    // reportInterval
+    // check if reportInterval is defined in the yaml file since it is optional
+    if (yaml["reportInterval"]) {
+        s.reportInterval = yaml["reportInterval"].as<int>();
+        if (s.reportInterval < 0) {
+            cerr << "Invalid reportInterval: " << s.reportInterval << ". It should be 0 or positive." << endl;
+            std::exit(-1);
+        }
+    }
+
+    // reportWallSeconds
+    // check if reportWallSeconds is defined in the yaml file since it is optional
+    if (yaml["reportWallSeconds"]) {
+        s.reportWallSeconds = yaml["reportWallSeconds"].as<double>();
+        if (s.reportWallSeconds < 0.0) {
+            cerr << "Invalid reportWallSeconds: " << s.reportWallSeconds << ". It should be 0 or positive." << endl;
+            std::exit(-1);
+        }
+    }
+
+    // progressLog
+    // check if progressLog is defined in the yaml file since it is optional
+    if (yaml["progressLog"]) {
+        s.progressLog = yaml["progressLog"].as<bool>();
+    }
+
+    // traceSteps
+    // check if traceSteps is defined in the yaml file since it is optional
+    if (yaml["traceSteps"]) {
+        s.traceSteps = yaml["traceSteps"].as<int>();
+        if (s.traceSteps < 0) {
+            cerr << "Invalid traceSteps: " << s.traceSteps << ". It should be 0 or positive." << endl;
+            std::exit(-1);
+        }
+    }
+
+    // loadBalanceInterval
+    // check if loadBalanceInterval is defined in the yaml file since it is optional
+    if (yaml["loadBalanceInterval"]) {
+        s.loadBalanceInterval = yaml["loadBalanceInterval"].as<int>();
+        if (s.loadBalanceInterval < 0) {
+            cerr << "Invalid loadBalanceInterval: " << s.loadBalanceInterval << ". It should be 0 or positive." << endl;
+            std::exit(-1);
+        }
+    }
+
+    // loadBalanceThreshold
+    // check if loadBalanceThreshold is defined in the yaml file since it is optional
+    if (yaml["loadBalanceThreshold"]) {
+        s.loadBalanceThreshold = yaml["loadBalanceThreshold"].as<double>();
+        if (s.loadBalanceThreshold < 0.0) {
+            cerr << "Invalid loadBalanceThreshold: " << s.loadBalanceThreshold << ". It should be 0 or positive."
+                 << endl;
+            std::exit(-1);
+        }
+    }
     return s;
 }
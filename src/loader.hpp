@@ -29,14 +29,25 @@ public:
      * output directory.
      * @param settingPath Path to the setting file
      * @param outputDirectory Path to the output directory
+     * @param isRestart If true, the particle file is neither loaded nor copied since the particles are restored from a
+     * checkpoint, and the setting file in the output directory is overwritten.
+     * @param copiesInputFiles If false, the input files are not copied, e.g. in the processes other than the first one
+     * in the distributed mode, which load the same files.
      * @return Input object
      */
-    Input load(const fs::path& settingPath, const fs::path& outputDirectory);
+    Input load(
+        const fs::path& settingPath,
+        const fs::path& outputDirectory,
+        bool isRestart        = false,
+        bool copiesInputFiles = true
+    );
 
 private:
     std::unique_ptr<ParticlesLoader::Interface> particlesLoader;
 
     std::unique_ptr<ParticlesLoader::Interface> getParticlesLoader(const fs::path& particlesPath);
-    void copyInputFileToOutputDirectory(const fs::path& inputFilePath, const fs::path& outputDirectory);
+    void copyInputFileToOutputDirectory(
+        const fs::path& inputFilePath, const fs::path& outputDirectory, bool overwrites = false
+    );
     Settings loadSettingYaml(const fs::path& settingPath);
 };
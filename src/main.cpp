@@ -46,6 +46,18 @@ int main(int argc, char** argv) {
             return value;
         });
 
+    program.add_argument("-r", "--restart")
+        .help("path to a checkpoint file, or a directory of checkpoint files, to restart the simulation from")
+        .action([](const std::string& value) {
+            if (!fs::exists(value)) {
+                cout << "ERROR: The checkpoint file " << value << " does not exist" << endl;
+                cerr << "ERROR: The checkpoint file " << value << " does not exist" << endl;
+                exit(-1);
+            }
+            cout << "Checkpoint file: " << value << endl;
+            return value;
+        });
+
     // Although the use of exeptions is prohibited by the guidelines of this project,
     // the following process is shown in the document of the argpase library,
     // so we use here as an execptional calse.
@@ -61,7 +73,8 @@ int main(int argc, char** argv) {
     // auto settingPath = fs::path(argv[1]);
     auto settingPath     = fs::path(program.get<std::string>("--setting"));
     auto outputDirectory = fs::path(program.get<std::string>("--output"));
-    Simulation simulation(settingPath, outputDirectory);
+    auto restartPath     = fs::path(program.present<std::string>("--restart").value_or(""));
+    Simulation simulation(settingPath, outputDirectory, restartPath);
     simulation.run();
 
     return 0;
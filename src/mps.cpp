@@ -1,13 +1,11 @@
 #include "mps.hpp"
 
+#include "neighbor_kernel.hpp"
 #include "particle.hpp"
 #include "weight.hpp"
 
 #include <queue>
-
-// This include is for checking if the pressure calculator is explicit.
-// This is needed because we need to update the pressure again when using EMPS.
-#include "pressure_calculator/explicit.hpp"
+#include <string>
 
 using std::cerr;
 using std::endl;
@@ -24,53 +22,179 @@ MPS::MPS(
     this->gravity            = gravity;
     this->pressureCalculator = std::move(pressureCalculator);
     this->surfaceDetector    = std::move(surfaceDetector);
-    this->neighborSearcher   = NeighborSearcher(input.settings.reMax, input.settings.domain, input.particles.size());
+    this->neighborSearcher   = NeighborSearcher(
+        input.settings.reMax,
+        input.settings.domain,
+        input.particles.size(),
+        input.settings.neighborSearchSkin,
+        input.settings.neighborSearchInterval,
+        input.settings.sparseBucket
+    );
 
     refValuesForNumberDensity = RefValues(settings.dim, settings.particleDistance, settings.re_forNumberDensity);
     refValuesForGradient      = RefValues(settings.dim, settings.particleDistance, settings.re_forGradient);
     refValuesForLaplacian     = RefValues(settings.dim, settings.particleDistance, settings.re_forLaplacian);
+    stages                    = this->pressureCalculator->stepStages();
+
+    // A tile is a cube of several cells of the bucket, and its particles are scheduled after the neighbor search.
+    double cellWidth    = settings.reMax + settings.neighborSearchSkin;
+    this->tileScheduler = TileScheduler(domain, settings.tileCells * cellWidth);
 }
 
-void MPS::stepForward() {
-    neighborSearcher.setNeighbors(particles);
-    calGravity();
-    calViscosity(settings.re_forLaplacian);
-    moveParticle();
+double MPS::stepForward(const std::function<void()>& output, TaskTrace* trace) {
+    if (settings.ghostCompactionInterval > 0 && ++stepsSinceCompaction >= settings.ghostCompactionInterval) {
+        stepsSinceCompaction = 0;
+        removeGhostParticles();
+    }
 
-    neighborSearcher.setNeighbors(particles);
-    collision();
+    // Each stage waits only for the earlier stages it conflicts with, so that the stages that read the same data, e.g.
+    // UpdateNumberDensity and Courant after the last move, run at the same time.
+    TaskGraph graph;
+    std::vector<StageAccess> accesses;
+    auto addTask = [&](const std::string& name,
+                       const std::function<void()>& function,
+                       const StageAccess& access,
+                       const bool runsAlone) {
+        std::vector<int> dependencies;
+        for (int i = 0; i < static_cast<int>(accesses.size()); i++) {
+            if (stepStageDependsOn(access, accesses[i]))
+                dependencies.push_back(i);
+        }
+        accesses.push_back(access);
+        graph.add(name, function, dependencies, runsAlone);
+    };
+    for (const auto& stage : stages) {
+        addTask(
+            stepStageName(stage), [this, stage] { runStage(stage); }, stepStageAccess(stage), stepStageRunsAlone(stage)
+        );
+    }
+    if (output) {
+        std::vector<ParticleData> all = {
+            ParticleData::Type,
+            ParticleData::Neighbors,
+            ParticleData::Position,
+            ParticleData::Velocity,
+            ParticleData::Acceleration,
+            ParticleData::NumberDensity,
+            ParticleData::BoundaryCondition,
+            ParticleData::Pressure,
+            ParticleData::MinimumPressure,
+        };
+        // Output written in the background only copies the particles, in tasks that share the threads of the round,
+        // e.g. with Courant. Output written in the time step compresses the files in parallel loops of its own.
+        addTask("Output", output, StageAccess{all, {}}, !settings.asyncOutput);
+    }
+    graph.run(trace);
 
-    neighborSearcher.setNeighbors(particles);
-    calNumberDensity(settings.re_forNumberDensity);
-    auto pressures = pressureCalculator->calc(particles);
-    for (auto& particle : particles) {
-        particle.pressure = pressures[particle.id];
+    for (int i = 0; i < static_cast<int>(stages.size()); i++) {
+        stageSeconds[stages[i]] += graph.getSeconds(i);
     }
+    return output ? graph.getExclusiveSeconds(static_cast<int>(stages.size())) : 0.0;
+}
+
+int MPS::getStepsSinceCompaction() const {
+    return stepsSinceCompaction;
+}
 
-    setMinimumPressure(settings.re_forGradient);
-    calPressureGradient(settings.re_forGradient);
-    moveParticleUsingPressureGradient();
+const NeighborSearcher& MPS::getNeighborSearcher() const {
+    return neighborSearcher;
+}
 
-    // Update pressure again when using EMPS
-    if (auto explicitPressureCalculator = dynamic_cast<PressureCalculator::Explicit*>(pressureCalculator.get())) {
-        auto pressures = explicitPressureCalculator->calc(particles);
-        for (auto& particle : particles) {
-            particle.pressure = pressures[particle.id];
-        }
+void MPS::restoreState(int stepsSinceCompaction, NeighborSearcher::State&& neighborSearcherState) {
+    this->stepsSinceCompaction = stepsSinceCompaction;
+    neighborSearcher.setState(std::move(neighborSearcherState));
+}
+
+std::vector<NeighborSearcher::EscapedParticle> MPS::takeEscapedParticles() {
+    return neighborSearcher.takeEscapedParticles();
+}
+
+const std::map<StepStage, double>& MPS::getStageSeconds() const {
+    return stageSeconds;
+}
+
+void MPS::requestNeighborSearch() {
+    neighborSearcher.requestSearch();
+}
+
+void MPS::scheduleTiles() {
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+    tileScheduler.build(particles, numThreads);
+}
+
+void MPS::removeGhostParticles() {
+    if (particles.removeGhosts() > 0) {
+        // ids have changed, so the neighbor lists have to be rebuilt before they are used
+        neighborSearcher.requestSearch();
     }
+}
 
-    calCourant();
+void MPS::runStage(const StepStage& stage) {
+    switch (stage) {
+    case StepStage::SearchNeighbors:
+        neighborSearcher.setNeighbors(particles);
+        scheduleTiles();
+        break;
+    case StepStage::UpdateNeighbors:
+        if (neighborSearcher.updateNeighbors(particles))
+            scheduleTiles();
+        break;
+    case StepStage::Gravity:
+        calGravity();
+        break;
+    case StepStage::Viscosity:
+        calViscosity(settings.re_forLaplacian);
+        break;
+    case StepStage::MoveParticle:
+        moveParticle();
+        break;
+    case StepStage::Collision:
+        collision();
+        break;
+    case StepStage::NumberDensity:
+        calNumberDensity(settings.re_forNumberDensity);
+        break;
+    case StepStage::Pressure:
+        calPressure();
+        break;
+    case StepStage::MinimumPressure:
+        setMinimumPressure(settings.re_forGradient);
+        break;
+    case StepStage::PressureGradient:
+        calPressureGradient(settings.re_forGradient);
+        break;
+    case StepStage::MoveParticleUsingPressureGradient:
+        moveParticleUsingPressureGradient();
+        break;
+    case StepStage::UpdateNumberDensity:
+        updateNumberDensity(settings.re_forNumberDensity);
+        break;
+    case StepStage::Courant:
+        calCourant();
+        break;
+    case StepStage::FusedPrediction:
+        fusedPrediction();
+        break;
+    case StepStage::FusedCollision:
+        collision(true);
+        break;
+    case StepStage::FusedCorrection:
+        fusedCorrection();
+        break;
+    }
 }
 
 void MPS::calGravity() {
-#pragma omp parallel for
-    for (auto& p : particles) {
+    forEachParticle([&](Particle& p) {
         if (p.type == ParticleType::Fluid) {
             p.acceleration += gravity;
         } else {
             p.acceleration.setZero();
         }
-    }
+    });
 }
 
 void MPS::calViscosity(const double& re) {
@@ -78,39 +202,28 @@ void MPS::calViscosity(const double& re) {
     double lambda = refValuesForLaplacian.lambda;
     double a      = (settings.kinematicViscosity) * (2.0 * settings.dim) / (n0 * lambda);
 
-#pragma omp parallel for
-    for (auto& pi : particles) {
+    forEachParticle([&](Particle& pi) {
         if (pi.type != ParticleType::Fluid)
-            continue;
-
-        Eigen::Vector3d viscosityTerm = Eigen::Vector3d::Zero();
-
-        for (auto& neighbor : pi.neighbors) {
-            auto& pj = particles[neighbor.id];
+            return;
 
-            if (neighbor.distance < settings.re_forLaplacian) {
-                double w = weight(neighbor.distance, re);
-                viscosityTerm += (pj.velocity - pi.velocity) * w;
-            }
-        }
+        Eigen::Vector3d viscosityTerm = NeighborKernel::viscosity(particles, pi, re);
 
         viscosityTerm *= a;
         pi.acceleration += viscosityTerm;
-    }
+    });
 }
 
 void MPS::moveParticle() {
-#pragma omp parallel for
-    for (auto& p : particles) {
+    forEachParticle([&](Particle& p) {
         if (p.type == ParticleType::Fluid) {
             p.velocity += p.acceleration * settings.dt;
             p.position += p.velocity * settings.dt;
         }
         p.acceleration.setZero();
-    }
+    });
 }
 
-void MPS::collision() {
+void MPS::collision(const bool measureDistance) {
     for (auto& pi : particles) {
         if (pi.type != ParticleType::Fluid)
             continue;
@@ -120,7 +233,8 @@ void MPS::collision() {
             if (pj.type == ParticleType::Fluid && pj.id >= pi.id)
                 continue;
 
-            if (neighbor.distance < settings.collisionDistance) {
+            double distance = measureDistance ? (pj.position - pi.position).norm() : neighbor.distance;
+            if (distance < settings.collisionDistance) {
 
                 double invMi = pi.inverseDensity();
                 double invMj = pj.inverseDensity();
@@ -134,7 +248,7 @@ void MPS::collision() {
                 pi.velocity -= impulse * invMi * normal;
                 pj.velocity += impulse * invMj * normal;
 
-                double depth           = settings.collisionDistance - neighbor.distance;
+                double depth           = settings.collisionDistance - distance;
                 double positionImpulse = depth * mass;
                 pi.position -= positionImpulse * invMi * normal;
                 pj.position += positionImpulse * invMj * normal;
@@ -147,21 +261,38 @@ void MPS::collision() {
 }
 
 void MPS::calNumberDensity(const double& re) {
-#pragma omp parallel for
-    for (auto& pi : particles) {
+    forEachParticle([&](Particle& pi) {
         pi.numberDensity = 0.0;
 
         if (pi.type == ParticleType::Ghost)
-            continue;
+            return;
 
         for (auto& neighbor : pi.neighbors)
             pi.numberDensity += weight(neighbor.distance, re);
-    }
+    });
+}
+
+void MPS::calPressure() {
+    auto pressures = pressureCalculator->calc(particles);
+    forEachParticle([&](Particle& particle) { particle.pressure = pressures[particle.id]; });
+}
+
+void MPS::updateNumberDensity(const double& re) {
+    forEachParticle([&](Particle& pi) {
+        pi.numberDensity = 0.0;
+
+        if (pi.type == ParticleType::Ghost)
+            return;
+
+        for (auto& neighbor : pi.neighbors) {
+            neighbor.distance = (particles[neighbor.id].position - pi.position).norm();
+            pi.numberDensity += weight(neighbor.distance, re);
+        }
+    });
 }
 
 void MPS::setBoundaryCondition() {
-#pragma omp parallel for
-    for (auto& pi : particles) {
+    forEachParticle([&](Particle& pi) {
         if (pi.type == ParticleType::Ghost || pi.type == ParticleType::DummyWall) {
             pi.boundaryCondition = FluidState::Ignored;
 
@@ -172,14 +303,11 @@ void MPS::setBoundaryCondition() {
                 pi.boundaryCondition = FluidState::Inner;
             }
         }
-    }
+    });
 }
 
 void MPS::setMinimumPressure(const double& re) {
-#pragma omp parallel for
-    for (auto& p : particles) {
-        p.minimumPressure = p.pressure;
-    }
+    forEachParticle([&](Particle& p) { p.minimumPressure = p.pressure; });
 
     for (auto& pi : particles) {
         if (pi.type == ParticleType::Ghost || pi.type == ParticleType::DummyWall)
@@ -203,40 +331,86 @@ void MPS::setMinimumPressure(const double& re) {
 void MPS::calPressureGradient(const double& re) {
     double a = settings.dim / refValuesForGradient.n0;
 
-#pragma omp parallel for
-    for (auto& pi : particles) {
+    forEachParticle([&](Particle& pi) {
         if (pi.type != ParticleType::Fluid)
-            continue;
+            return;
 
-        Eigen::Vector3d grad = Eigen::Vector3d::Zero();
-        for (auto& neighbor : pi.neighbors) {
-            Particle& pj = particles[neighbor.id];
-            if (pj.type == ParticleType::Ghost || pj.type == ParticleType::DummyWall)
-                continue;
+        Eigen::Vector3d grad = NeighborKernel::pressureGradient(particles, pi, re);
+        grad *= a;
+        pi.acceleration -= grad / pi.density;
+    });
+}
 
-            if (neighbor.distance < re) {
-                double w = weight(neighbor.distance, re);
-                // double dist2 = pow(neighbor.distance, 2);
-                double dist2 = (pj.position - pi.position).squaredNorm();
-                double pij   = (pj.pressure - pi.minimumPressure) / dist2;
-                grad += (pj.position - pi.position) * pij * w;
+void MPS::moveParticleUsingPressureGradient() {
+    forEachParticle([&](Particle& p) {
+        if (p.type == ParticleType::Fluid) {
+            p.velocity += p.acceleration * settings.dt;
+            p.position += p.acceleration * settings.dt * settings.dt;
+        }
+
+        p.acceleration.setZero();
+    });
+}
+
+void MPS::fusedPrediction() {
+    double n0     = refValuesForLaplacian.n0;
+    double lambda = refValuesForLaplacian.lambda;
+    double a      = (settings.kinematicViscosity) * (2.0 * settings.dim) / (n0 * lambda);
+
+    forEachParticle([&](Particle& pi) {
+        if (pi.type != ParticleType::Fluid) {
+            pi.acceleration.setZero();
+            return;
+        }
+
+        pi.acceleration += gravity + NeighborKernel::viscosity(particles, pi, settings.re_forLaplacian) * a;
+    });
+
+    // All the accelerations are calculated before any particle moves, and each thread moves the particles of the same
+    // tiles, which are still in its cache.
+    forEachParticle([&](Particle& p) {
+        if (p.type == ParticleType::Fluid) {
+            p.velocity += p.acceleration * settings.dt;
+            p.position += p.velocity * settings.dt;
+        }
+        p.acceleration.setZero();
+    });
+}
+
+void MPS::fusedCorrection() {
+    double re = settings.re_forGradient;
+    double a  = settings.dim / refValuesForGradient.n0;
+
+    forEachParticle([&](Particle& pi) {
+        // Same as setMinimumPressure() for all the particles, since it is also written to the output. Neighbor lists
+        // are symmetric, so the minimum of each particle can be taken over its own neighbors.
+        pi.minimumPressure = pi.pressure;
+        if (pi.type != ParticleType::Ghost && pi.type != ParticleType::DummyWall) {
+            for (auto& neighbor : pi.neighbors) {
+                const Particle& pj = particles[neighbor.id];
+                if (pj.type == ParticleType::Ghost || pj.type == ParticleType::DummyWall)
+                    continue;
+                if (neighbor.distance < re)
+                    pi.minimumPressure = std::min(pi.minimumPressure, pj.pressure);
             }
         }
+
+        if (pi.type != ParticleType::Fluid)
+            return;
+
+        Eigen::Vector3d grad = NeighborKernel::pressureGradient(particles, pi, re);
         grad *= a;
         pi.acceleration -= grad / pi.density;
-    }
-}
+    });
 
-void MPS::moveParticleUsingPressureGradient() {
-#pragma omp parallel for
-    for (auto&& p : particles) {
+    forEachParticle([&](Particle& p) {
         if (p.type == ParticleType::Fluid) {
             p.velocity += p.acceleration * settings.dt;
             p.position += p.acceleration * settings.dt * settings.dt;
         }
 
         p.acceleration.setZero();
-    }
+    });
 }
 
 void MPS::calCourant() {
@@ -9,10 +9,15 @@
 #include "pressure_calculator/interface.hpp"
 #include "refvalues.hpp"
 #include "settings.hpp"
+#include "step_stage.hpp"
 #include "surface_detector/interface.hpp"
+#include "task_graph.hpp"
+#include "tile_scheduler.hpp"
 
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
+#include <functional>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -36,6 +41,8 @@ public:
 
     double courant{}; ///< Maximum courant number among all particles
 
+    std::vector<StepStage> stages; ///< Stages executed in a time step. Declared by the pressure calculator.
+
     MPS() = default;
 
     MPS(const Input& input,
@@ -43,11 +50,87 @@ public:
         std::unique_ptr<PressureCalculator::Interface>&& pressureCalculator,
         std::unique_ptr<SurfaceDetector::Interface>&& surfaceDetector);
 
-    void stepForward();
+    /**
+     * @brief advance the simulation by one time step
+     * @details Executes #stages as a TaskGraph, in which each stage waits for the earlier stages that write the data of
+     * the particles it accesses or access the data it writes (see stepStageDependsOn()). Ghost particles are removed
+     * beforehand every Settings::ghostCompactionInterval steps.
+     * @param output task that reads the particles after the stages have updated them, e.g. saving them. It does not
+     * wait for the last stages that only read the particles, e.g. Courant. It runs at the same time as them when
+     * Settings::asyncOutput is set, since it then only copies the particles, and alone otherwise.
+     * @param trace trace to add the stages to (null: not traced)
+     * @return wall-clock seconds in which only the output ran, i.e. the time the step waited for it
+     */
+    double stepForward(const std::function<void()>& output = nullptr, TaskTrace* trace = nullptr);
+
+    /**
+     * @brief number of time steps since ghost particles were removed
+     */
+    int getStepsSinceCompaction() const;
+
+    /**
+     * @brief neighbor searcher, whose state is kept between time steps
+     */
+    const NeighborSearcher& getNeighborSearcher() const;
+
+    /**
+     * @brief restore the state kept between time steps, e.g. from a checkpoint
+     * @param stepsSinceCompaction number of time steps since ghost particles were removed
+     * @param neighborSearcherState state of the neighbor searcher. The neighbor lists of #particles have to be
+     * restored as well if the neighbor searcher reuses them.
+     */
+    void restoreState(int stepsSinceCompaction, NeighborSearcher::State&& neighborSearcherState);
+
+    /**
+     * @brief take the particles that have left the domain and become ghost particles since the last call
+     */
+    std::vector<NeighborSearcher::EscapedParticle> takeEscapedParticles();
+
+    /**
+     * @brief wall-clock seconds spent in each stage since the simulation started
+     */
+    const std::map<StepStage, double>& getStageSeconds() const;
+
+    /**
+     * @brief execute a stage of the time step
+     * @details Used by stepForward(), and by drivers that run the stages themselves, e.g. to exchange particles with
+     * other processes between the stages (see Distributed::DistributedMPS).
+     * @param stage stage to execute
+     */
+    void runStage(const StepStage& stage);
+
+    /**
+     * @brief make the next neighbor search of UpdateNeighbors stage search neighbors again
+     * @details Call this when #particles are replaced, since the neighbor lists and the ids in them are invalidated.
+     */
+    void requestNeighborSearch();
 
 private:
     NeighborSearcher neighborSearcher;                           ///< Neighbor searcher for neighbor search
     std::unique_ptr<SurfaceDetector::Interface> surfaceDetector; ///< Interface for free surface detection
+    int stepsSinceCompaction{};                                  ///< Number of time steps since ghosts were removed
+    std::map<StepStage, double> stageSeconds;                    ///< Wall-clock seconds spent in each stage
+    TileScheduler tileScheduler;                                 ///< Scheduler of the loops over particles
+
+    /**
+     * @brief group the particles into the tiles of #tileScheduler and assign them to the threads
+     */
+    void scheduleTiles();
+
+    /**
+     * @brief call the function for each particle in parallel, in the tiles assigned to the threads
+     * @details The tiles are scheduled again if the particles have been replaced since the last neighbor search.
+     */
+    template <typename Function> void forEachParticle(const Function& function) {
+        if (tileScheduler.numParticles() != particles.size())
+            scheduleTiles();
+        tileScheduler.forEach([&](const int id) { function(particles[id]); });
+    }
+
+    /**
+     * @brief remove ghost particles so that the loops over particles scale with the particles in the domain
+     */
+    void removeGhostParticles();
 
     /**
      * @brief calculate gravity term
@@ -77,8 +160,10 @@ private:
 
     /**
      *@brief calculate collision between particles when they are too close
+     * @param measureDistance if true, the distance between particles is measured at the current positions instead of
+     * using the distance stored in the neighbor list
      */
-    void collision();
+    void collision(const bool measureDistance = false);
 
     /**
      * @brief calculate number density of each particle
@@ -86,6 +171,17 @@ private:
      */
     void calNumberDensity(const double& re);
 
+    /**
+     * @brief calculate pressure by the pressure calculator
+     */
+    void calPressure();
+
+    /**
+     * @brief update number density to the current positions without searching neighbors again
+     * @param re effective radius \f$r_e\f$
+     */
+    void updateNumberDensity(const double& re);
+
     /**
      *@brief set boundary condition of pressure Poisson equation
      */
@@ -136,6 +232,21 @@ private:
      */
     void moveParticleUsingPressureGradient();
 
+    /**
+     * @brief prediction step of the explicit scheme fused into a single pass over the neighbors
+     * @details Gravity and viscosity terms are calculated together, and then the particles are moved as in
+     * moveParticle().
+     */
+    void fusedPrediction();
+
+    /**
+     * @brief correction step of the explicit scheme fused into a single pass over the neighbors
+     * @details The minimum pressure and the pressure gradient of each fluid particle are calculated while its neighbors
+     * are in cache, and then the particles are moved as in moveParticleUsingPressureGradient(). The distances in the
+     * neighbor lists must be up to date (see updateNumberDensity()).
+     */
+    void fusedCorrection();
+
     /**
      * @brief calculate Courant number
      */
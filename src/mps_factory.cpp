@@ -19,26 +19,7 @@ MPS MPSFactory::create(const Input& input) {
         gravity << gNorm * sin(theta), -gNorm * cos(theta), 0.0; // Gravity in XY plane
     }
 
-    RefValues refValuesForNumberDensity(
-        input.settings.dim,
-        input.settings.particleDistance,
-        input.settings.re_forNumberDensity
-    );
-
-    std::unique_ptr<SurfaceDetector::Interface> surfaceDetector;
-    if (input.settings.surfaceDetection_particleDistribution) {
-        surfaceDetector.reset(new SurfaceDetector::Distribution(
-            refValuesForNumberDensity.n0,
-            input.settings.particleDistance,
-            input.settings.surfaceDetection_particleDistribution_threshold,
-            input.settings.surfaceDetection_numberDensity_threshold
-        ));
-    } else {
-        surfaceDetector.reset(new SurfaceDetector::NumberDensity(
-            input.settings.surfaceDetection_numberDensity_threshold,
-            refValuesForNumberDensity.n0
-        ));
-    }
+    std::unique_ptr<SurfaceDetector::Interface> surfaceDetector = createSurfaceDetector(input.settings);
 
     std::unique_ptr<DirichletBoundaryConditionGenerator::Interface> DirichletBoundaryConditionGenerator;
     DirichletBoundaryConditionGenerator.reset(
@@ -62,7 +43,8 @@ MPS MPSFactory::create(const Input& input) {
             input.settings.re_forNumberDensity,
             input.settings.soundSpeed,
             input.settings.dim,
-            input.settings.particleDistance
+            input.settings.particleDistance,
+            input.settings.fuseExplicitStages
         ));
     } else {
         std::cerr << "Invalid pressure calculation method: " << input.settings.pressureCalculationMethod << std::endl;
@@ -72,3 +54,22 @@ MPS MPSFactory::create(const Input& input) {
 
     return MPS(input, gravity, std::move(pressureCalculator), std::move(surfaceDetector));
 }
+
+std::unique_ptr<SurfaceDetector::Interface> MPSFactory::createSurfaceDetector(const Settings& settings) {
+    RefValues refValuesForNumberDensity(settings.dim, settings.particleDistance, settings.re_forNumberDensity);
+
+    std::unique_ptr<SurfaceDetector::Interface> surfaceDetector;
+    if (settings.surfaceDetection_particleDistribution) {
+        surfaceDetector.reset(new SurfaceDetector::Distribution(
+            refValuesForNumberDensity.n0,
+            settings.particleDistance,
+            settings.surfaceDetection_particleDistribution_threshold,
+            settings.surfaceDetection_numberDensity_threshold
+        ));
+    } else {
+        surfaceDetector.reset(new SurfaceDetector::NumberDensity(
+            settings.surfaceDetection_numberDensity_threshold, refValuesForNumberDensity.n0
+        ));
+    }
+    return surfaceDetector;
+}
@@ -6,4 +6,9 @@
 class MPSFactory {
 public:
     static MPS create(const Input& input);
+
+    /**
+     * @brief create the free surface detector chosen in the settings
+     */
+    static std::unique_ptr<SurfaceDetector::Interface> createSurfaceDetector(const Settings& settings);
 };
@@ -0,0 +1,37 @@
+#include "neighbor_kernel.hpp"
+
+#include "weight.hpp"
+
+Eigen::Vector3d NeighborKernel::viscosity(const Particles& particles, const Particle& pi, const double& re) {
+    Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+
+    for (auto& neighbor : pi.neighbors) {
+        auto& pj = particles[neighbor.id];
+
+        if (neighbor.distance < re) {
+            double w = weight(neighbor.distance, re);
+            sum += (pj.velocity - pi.velocity) * w;
+        }
+    }
+
+    return sum;
+}
+
+Eigen::Vector3d NeighborKernel::pressureGradient(const Particles& particles, const Particle& pi, const double& re) {
+    Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+
+    for (auto& neighbor : pi.neighbors) {
+        const Particle& pj = particles[neighbor.id];
+        if (pj.type == ParticleType::Ghost || pj.type == ParticleType::DummyWall)
+            continue;
+
+        if (neighbor.distance < re) {
+            double w     = weight(neighbor.distance, re);
+            double dist2 = (pj.position - pi.position).squaredNorm();
+            double pij   = (pj.pressure - pi.minimumPressure) / dist2;
+            sum += (pj.position - pi.position) * pij * w;
+        }
+    }
+
+    return sum;
+}
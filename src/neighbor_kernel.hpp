@@ -0,0 +1,34 @@
+#pragma once
+
+#include "common.hpp"
+#include "particles.hpp"
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Kernels that sum up the interaction between a particle and its neighbors
+ *
+ * @details They are shared by the separate stages of a time step and the fused stages of the explicit method.
+ */
+namespace NeighborKernel {
+
+/**
+ * @brief sum of the viscosity interaction of the particle
+ * @param particles all the particles
+ * @param pi particle to calculate
+ * @param re effective radius \f$r_e\f$
+ * @return \f$\sum_{j\neq i} (\mathbf{u}_j - \mathbf{u}_i) w_{ij}\f$
+ */
+Eigen::Vector3d viscosity(const Particles& particles, const Particle& pi, const double& re);
+
+/**
+ * @brief sum of the pressure gradient interaction of the particle
+ * @param particles all the particles
+ * @param pi particle to calculate
+ * @param re effective radius \f$r_e\f$
+ * @return \f$\sum_{j\neq i} \frac{P_j-P'_i}{\|\mathbf{r}_{ij}\|^2}\mathbf{r}_{ij} w_{ij}\f$, where ghost and dummy wall
+ * neighbors are excluded.
+ */
+Eigen::Vector3d pressureGradient(const Particles& particles, const Particle& pi, const double& re);
+
+} // namespace NeighborKernel
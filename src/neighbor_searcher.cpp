@@ -1,16 +1,44 @@
 #include "neighbor_searcher.hpp"
 
 #include "bucket.hpp"
+#include "sparse_bucket.hpp"
 
-NeighborSearcher::NeighborSearcher(const double& re, const Domain& domain, const size_t& particleSize) {
-    this->re     = re;
-    this->domain = domain;
-    this->bucket = Bucket(re, domain, particleSize);
+#include <algorithm>
+#include <utility>
+
+NeighborSearcher::NeighborSearcher(
+    const double& re,
+    const Domain& domain,
+    const size_t& particleSize,
+    const double& skin,
+    const int& searchInterval,
+    const bool& usesSparseBucket
+) {
+    this->re               = re + skin;
+    this->domain           = domain;
+    this->skin             = skin;
+    this->searchInterval   = searchInterval;
+    this->usesSparseBucket = usesSparseBucket;
+    // only the bucket in use is allocated
+    if (usesSparseBucket) {
+        this->sparseBucket = SparseBucket(this->re, domain, particleSize);
+    } else {
+        this->bucket = Bucket(this->re, domain, particleSize);
+    }
 }
 
 void NeighborSearcher::setNeighbors(Particles& particles) {
-    bucket.storeParticles(particles);
+    ghostParticlesOutOfDomain(particles);
+    if (usesSparseBucket) {
+        sparseBucket.storeParticles(particles);
+        searchInBucket(particles, sparseBucket);
+    } else {
+        bucket.storeParticles(particles);
+        searchInBucket(particles, bucket);
+    }
+}
 
+template <typename BucketType> void NeighborSearcher::searchInBucket(Particles& particles, const BucketType& bucket) {
 #pragma omp parallel for
     for (auto& pi : particles) {
         if (pi.type == ParticleType::Ghost)
@@ -25,8 +53,7 @@ void NeighborSearcher::setNeighbors(Particles& particles) {
         for (int jx = ix - 1; jx <= ix + 1; jx++) {
             for (int jy = iy - 1; jy <= iy + 1; jy++) {
                 for (int jz = iz - 1; jz <= iz + 1; jz++) {
-                    int jBucket = jx + jy * bucket.numX + jz * bucket.numX * bucket.numY;
-                    int j       = bucket.first[jBucket];
+                    int j = bucket.getFirst(jx, jy, jz);
 
                     while (j != -1) {
                         Particle& pj = particles[j];
@@ -43,3 +70,109 @@ void NeighborSearcher::setNeighbors(Particles& particles) {
         }
     }
 }
+
+void NeighborSearcher::updateDistances(Particles& particles) {
+#pragma omp parallel for
+    for (auto& pi : particles) {
+        if (pi.type == ParticleType::Ghost)
+            continue;
+
+        for (auto& neighbor : pi.neighbors) {
+            neighbor.distance = (particles[neighbor.id].position - pi.position).norm();
+        }
+    }
+}
+
+bool NeighborSearcher::updateNeighbors(Particles& particles) {
+    state.callsSinceSearch++;
+    bool needsSearch = state.isSearchRequested || state.callsSinceSearch >= searchInterval;
+    if (!needsSearch) {
+        needsSearch = hasMovedBeyondSkin(particles);
+    }
+
+    if (!needsSearch) {
+        updateDistances(particles);
+        return false;
+    }
+
+    setNeighbors(particles);
+    state.callsSinceSearch  = 0;
+    state.isSearchRequested = false;
+    if (reusesNeighbors()) {
+        state.positionsAtSearch.resize(particles.size());
+#pragma omp parallel for
+        for (const auto& p : particles) {
+            state.positionsAtSearch[p.id] = p.position;
+        }
+    }
+    return true;
+}
+
+void NeighborSearcher::requestSearch() {
+    state.isSearchRequested = true;
+}
+
+bool NeighborSearcher::reusesNeighbors() const {
+    return searchInterval > 1;
+}
+
+NeighborSearcher::State NeighborSearcher::getState() const {
+    return state;
+}
+
+void NeighborSearcher::setState(State&& state) {
+    this->state = std::move(state);
+}
+
+std::vector<NeighborSearcher::EscapedParticle> NeighborSearcher::takeEscapedParticles() {
+    return std::exchange(escapedParticles, {});
+}
+
+void NeighborSearcher::ghostParticlesOutOfDomain(Particles& particles) {
+    std::vector<int> escapedIds;
+#pragma omp parallel
+    {
+        std::vector<int> localIds;
+#pragma omp for nowait
+        for (int i = 0; i < particles.size(); i++) {
+            const Particle& p = particles[i];
+            if (p.type != ParticleType::Ghost && !isInDomain(p.position)) {
+                localIds.push_back(i);
+            }
+        }
+#pragma omp critical
+        escapedIds.insert(escapedIds.end(), localIds.begin(), localIds.end());
+    }
+    if (escapedIds.empty())
+        return;
+
+    // sorted so that the order does not depend on the threads
+    std::sort(escapedIds.begin(), escapedIds.end());
+    for (int id : escapedIds) {
+        Particle& p = particles[id];
+        p.type      = ParticleType::Ghost;
+        escapedParticles.push_back({p.id, p.originalId, p.position});
+    }
+}
+
+bool NeighborSearcher::isInDomain(const Eigen::Vector3d& position) const {
+    return domain.xMin <= position.x() && position.x() <= domain.xMax && domain.yMin <= position.y() &&
+           position.y() <= domain.yMax && domain.zMin <= position.z() && position.z() <= domain.zMax;
+}
+
+bool NeighborSearcher::hasMovedBeyondSkin(const Particles& particles) const {
+    const auto& positionsAtSearch = state.positionsAtSearch;
+    if (positionsAtSearch.size() != static_cast<size_t>(particles.size()))
+        return true;
+
+    double maxDisplacement2 = 0.0;
+#pragma omp parallel for reduction(max : maxDisplacement2)
+    for (const auto& p : particles) {
+        if (p.type == ParticleType::Ghost)
+            continue;
+        maxDisplacement2 = std::max(maxDisplacement2, (p.position - positionsAtSearch[p.id]).squaredNorm());
+    }
+
+    // A pair of particles approaches each other by at most twice the maximum displacement.
+    return 4.0 * maxDisplacement2 > skin * skin;
+}
@@ -1,19 +1,132 @@
+#pragma once
+
 #include "bucket.hpp"
 #include "domain.hpp"
 #include "particles.hpp"
+#include "sparse_bucket.hpp"
 
+#include <Eigen/Dense>
 #include <vector>
 
 class NeighborSearcher {
 public:
+    /**
+     * @brief state kept between calls of updateNeighbors(), which is saved in checkpoints
+     */
+    struct State {
+        int callsSinceSearch{};                         ///< number of calls since the last search
+        bool isSearchRequested = true;                  ///< whether the next call searches neighbors
+        std::vector<Eigen::Vector3d> positionsAtSearch; ///< positions of the particles at the last search
+    };
+
+    /**
+     * @brief particle that has left the domain and become a ghost particle
+     */
+    struct EscapedParticle {
+        int id{};                 ///< id of the particle when it left the domain
+        int originalId{};         ///< id of the particle when it was loaded
+        Eigen::Vector3d position; ///< position where it was found out of the domain
+    };
+
     NeighborSearcher() = default;
 
-    NeighborSearcher(const double& re, const Domain& domain, const size_t& particleSize);
+    /**
+     * @param re radius within which neighbors are searched
+     * @param domain domain of the simulation
+     * @param particleSize number of particles
+     * @param skin extra radius added to re so that the neighbor lists stay valid for several steps (see
+     * updateNeighbors())
+     * @param searchInterval maximum number of calls of updateNeighbors() per neighbor search
+     * @param usesSparseBucket if true, particles are stored in SparseBucket instead of Bucket, which saves memory
+     * and time when the particles occupy a small part of the domain
+     */
+    NeighborSearcher(
+        const double& re,
+        const Domain& domain,
+        const size_t& particleSize,
+        const double& skin           = 0.0,
+        const int& searchInterval    = 1,
+        const bool& usesSparseBucket = false
+    );
 
+    /**
+     * @brief search neighbors of all the particles
+     * @details Particles out of the domain are turned into ghost particles first (see ghostParticlesOutOfDomain()).
+     * @param particles particles whose neighbor lists are set
+     */
     void setNeighbors(Particles& particles);
 
+    /**
+     * @brief search neighbors only when the neighbor lists may be outdated
+     * @details The neighbor lists contain all the particles within re + skin. As long as no particle has moved more
+     * than half of the skin since the last search, they still contain all the particles within re, so only the
+     * distances are updated. Neighbors are searched again after searchInterval calls, when a particle has moved more
+     * than half of the skin, or when requestSearch() has been called.
+     * @param particles particles to update
+     * @return true if neighbors were searched
+     */
+    bool updateNeighbors(Particles& particles);
+
+    /**
+     * @brief make the next updateNeighbors() search neighbors
+     * @details Call this when the neighbor lists are invalidated, e.g. when particles are added or removed.
+     */
+    void requestSearch();
+
+    /**
+     * @brief update the distances in the neighbor lists to the current positions without searching neighbors again
+     * @param particles particles whose neighbor lists are set by setNeighbors()
+     */
+    void updateDistances(Particles& particles);
+
+    /**
+     * @brief whether the neighbor lists are reused in later calls of updateNeighbors()
+     * @details If so, the neighbor lists are part of the state of the simulation and have to be saved in checkpoints.
+     */
+    bool reusesNeighbors() const;
+
+    State getState() const;
+
+    void setState(State&& state);
+
+    /**
+     * @brief take the particles that have left the domain since the last call
+     * @return particles in the order of their ids at each search
+     */
+    std::vector<EscapedParticle> takeEscapedParticles();
+
 private:
     double re;
     Domain domain;
-    Bucket bucket;
+    Bucket bucket;             ///< used unless usesSparseBucket
+    SparseBucket sparseBucket; ///< used if usesSparseBucket
+    bool usesSparseBucket = false;
+
+    double skin        = 0.0;
+    int searchInterval = 1;
+    State state;
+    std::vector<EscapedParticle> escapedParticles; ///< particles that have left the domain since they were taken
+
+    /**
+     * @brief turn the particles out of the domain into ghost particles and record them in #escapedParticles
+     * @details The particles are checked in parallel and converted together, so that the buckets can assume that all
+     * the particles they store are in the domain.
+     */
+    void ghostParticlesOutOfDomain(Particles& particles);
+
+    /**
+     * @brief whether the position is in the domain
+     */
+    bool isInDomain(const Eigen::Vector3d& position) const;
+
+    /**
+     * @brief whether any particle has moved more than half of the skin since the last search
+     */
+    bool hasMovedBeyondSkin(const Particles& particles) const;
+
+    /**
+     * @brief search neighbors of all the particles in the bucket where they are stored
+     * @tparam BucketType Bucket or SparseBucket
+     */
+    template <typename BucketType> void searchInBucket(Particles& particles, const BucketType& bucket);
 };
@@ -0,0 +1,118 @@
+#include "output_writer.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+using std::cerr;
+using std::endl;
+
+OutputWriter::OutputWriter(const bool async, const std::vector<ParticleField>& capturedFields) {
+    this->async          = async;
+    this->capturedFields = capturedFields;
+    for (int i = numBuffers - 1; i >= 0; i--) {
+        freeBuffers.push_back(i);
+    }
+
+    if (async) {
+        writerThread = std::thread(&OutputWriter::runTasks, this);
+    }
+}
+
+OutputWriter::~OutputWriter() {
+    if (!async)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    condition.notify_all();
+    writerThread.join();
+}
+
+void OutputWriter::write(const Particles& particles, Task task) {
+    if (!async) {
+        // the files are written before the particles change, so they are exported without a copy
+        auto start = std::chrono::steady_clock::now();
+        exporters[0].setParticles(particles);
+        hasFailed = !task(exporters[0]);
+        taskSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        exitIfFailed();
+        return;
+    }
+
+    exitIfFailed();
+
+    int buffer{};
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return !freeBuffers.empty(); });
+        buffer = freeBuffers.back();
+        freeBuffers.pop_back();
+    }
+
+    // The buffer is not used by the writer thread until the task is queued, so it can be filled without the lock.
+    snapshots[buffer].capture(particles, capturedFields);
+    exporters[buffer].setParticles(ParticlesView(snapshots[buffer]));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.emplace(buffer, std::move(task));
+    }
+    condition.notify_all();
+}
+
+void OutputWriter::finish() {
+    if (!async)
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return freeBuffers.size() == numBuffers; });
+    }
+    exitIfFailed();
+}
+
+double OutputWriter::getTaskSeconds() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return taskSeconds;
+}
+
+void OutputWriter::runTasks() {
+    while (true) {
+        std::pair<int, Task> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return !tasks.empty() || isStopping; });
+            // queued tasks are run before stopping so that no output is lost
+            if (tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool written   = task.second(exporters[task.first]);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeBuffers.push_back(task.first);
+            taskSeconds += seconds;
+            hasFailed   = hasFailed || !written;
+        }
+        condition.notify_all();
+    }
+}
+
+void OutputWriter::exitIfFailed() {
+    bool failed{};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = hasFailed;
+    }
+    if (failed) {
+        cerr << "ERROR: failed to write output files." << endl;
+        std::exit(-1);
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "common.hpp"
+#include "particles.hpp"
+#include "particle_field.hpp"
+#include "particles_exporter.hpp"
+#include "particles_snapshot.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Writes output files of particles in a background thread
+ *
+ * @details write() copies the exported fields of the particles into one of #numBuffers snapshots (double buffering)
+ * and queues the task that writes the files. The simulation continues while a writer thread runs the tasks in order.
+ * When all the buffers are in use, write() waits until the oldest task has finished, so at most #numBuffers copies
+ * of the particles exist at a time. A task that fails to write its files stops the simulation in the next write() or
+ * finish(), i.e. in the thread of the simulation rather than in the writer thread.
+ */
+class OutputWriter {
+public:
+    /// @brief task that writes files using an exporter whose particles are already set. It returns whether the files
+    /// have been written.
+    using Task = std::function<bool(ParticlesExporter&)>;
+
+    /// @brief number of buffers, i.e. maximum number of tasks that are queued or running
+    static constexpr int numBuffers = 2;
+
+    /**
+     * @param async if true, tasks are run in a writer thread. Otherwise they are run in write() without copying the
+     * particles.
+     * @param capturedFields fields copied in addition to the position, i.e. the fields the tasks can write
+     */
+    explicit OutputWriter(const bool async, const std::vector<ParticleField>& capturedFields = allParticleFields());
+
+    /**
+     * @brief wait for all the tasks to finish and stop the writer thread
+     */
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&)            = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    /**
+     * @brief copy the particles and write them by the task
+     * @param particles particles to write. They can be changed after this call.
+     * @param task task that writes files
+     */
+    void write(const Particles& particles, Task task);
+
+    /**
+     * @brief wait until all the tasks have finished
+     */
+    void finish();
+
+    /**
+     * @brief total wall-clock seconds spent in the tasks that have finished
+     */
+    double getTaskSeconds();
+
+private:
+    bool async;
+    std::vector<ParticleField> capturedFields;
+    std::array<ParticlesSnapshot, numBuffers> snapshots; ///< copies of the particles
+    std::array<ParticlesExporter, numBuffers> exporters; ///< exporters of the snapshots
+
+    std::mutex mutex;
+    std::condition_variable condition;      ///< notified when a task is queued or finished
+    std::queue<std::pair<int, Task>> tasks; ///< queued tasks and the indices of their buffers
+    std::vector<int> freeBuffers;           ///< indices of buffers not used by any task
+    bool isStopping = false;                ///< whether the writer thread should stop
+    bool hasFailed  = false;                ///< whether any task has failed to write its files
+    double taskSeconds{};                   ///< total wall-clock seconds of the finished tasks
+    std::thread writerThread;
+
+    /**
+     * @brief main loop of the writer thread
+     */
+    void runTasks();
+
+    /**
+     * @brief exit if any task has failed to write its files
+     */
+    void exitIfFailed();
+};
@@ -1,12 +1,13 @@
 #include "particle.hpp"
 
 Particle::Particle(int id, ParticleType type, Eigen::Vector3d pos, Eigen::Vector3d vel, double density, int fluidType) {
-    this->id        = id;
-    this->type      = type;
-    this->position  = pos;
-    this->velocity  = vel;
-    this->density   = density;
-    this->fluidType = fluidType;
+    this->id         = id;
+    this->originalId = id;
+    this->type       = type;
+    this->position   = pos;
+    this->velocity   = vel;
+    this->density    = density;
+    this->fluidType  = fluidType;
 }
 
 double Particle::inverseDensity() const {
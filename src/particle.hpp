@@ -48,6 +48,7 @@ class Particle {
 private:
 public:
     int id;            ///< index of the particle
+    int originalId;    ///< id of the particle when it was loaded. It is kept when ghost particles are removed.
     ParticleType type; ///< type of the particle
     int fluidType = 0; ///< type of the fluid. This is used for simulation of multiple fluid types. When treating only
                        ///< one fluid, this property is not used. Default value is 0.
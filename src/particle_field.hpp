@@ -0,0 +1,35 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <vector>
+
+/**
+ * @brief Field of particles that can be exported to files
+ *
+ * @details The position is always exported, so it is not listed here.
+ */
+enum class ParticleField {
+    Type,              ///< particle type
+    Velocity,          ///< velocity
+    Pressure,          ///< pressure
+    NumberDensity,     ///< number density (and its ratio to the reference value in the VTK format)
+    BoundaryCondition, ///< boundary condition of the pressure Poisson equation
+    FluidType,         ///< type of the fluid
+    OriginalId,        ///< id of the particle when it was loaded
+};
+
+/**
+ * @brief all the fields of particles that can be exported
+ */
+inline std::vector<ParticleField> allParticleFields() {
+    return {
+        ParticleField::Type,
+        ParticleField::Velocity,
+        ParticleField::Pressure,
+        ParticleField::NumberDensity,
+        ParticleField::BoundaryCondition,
+        ParticleField::FluidType,
+        ParticleField::OriginalId,
+    };
+}
@@ -1,5 +1,6 @@
 #include "particles.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -30,6 +31,27 @@ void Particles::add(const Particle& particle) {
     particles.emplace_back(particle);
 }
 
+void Particles::reserve(size_t capacity) {
+    particles.reserve(capacity);
+}
+
+int Particles::removeGhosts() {
+    auto isGhost = [](const Particle& p) { return p.type == ParticleType::Ghost; };
+    auto newEnd  = std::remove_if(particles.begin(), particles.end(), isGhost);
+    int removed  = static_cast<int>(particles.end() - newEnd);
+    if (removed == 0)
+        return 0;
+
+    particles.erase(newEnd, particles.end());
+#pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(particles.size()); i++) {
+        particles[i].id = i;
+        particles[i].neighbors.clear();
+    }
+
+    return removed;
+}
+
 Particle& Particles::operator[](size_t index) {
     return particles[index];
 }
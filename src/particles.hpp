@@ -29,6 +29,24 @@ public:
      */
     void add(const Particle& particle);
 
+    /**
+     * @brief Reserve memory for particles to be added
+     *
+     * @param capacity the number of particles
+     */
+    void reserve(size_t capacity);
+
+    /**
+     * @brief Remove ghost particles from the collection
+     *
+     * @details The remaining particles keep their order and are given new ids equal to their new indices. Their
+     * original ids are kept in Particle::originalId. Since the ids in the neighbor lists are no longer valid, the
+     * neighbor lists are cleared and neighbors have to be searched again.
+     *
+     * @return int the number of removed particles
+     */
+    int removeGhosts();
+
     /**
      * @brief Get a particle by index
      *
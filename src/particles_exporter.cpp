@@ -1,10 +1,13 @@
 #include "particles_exporter.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <zlib.h>
 
 using std::cerr;
 using std::endl;
@@ -45,31 +48,298 @@ std::string ParticlesExporter::dataArrayEnd() const {
     return "</DataArray>";
 }
 
+template <typename T, typename Getter>
+ParticlesExporter::DataArray
+ParticlesExporter::scalarArray(const std::string& type, const std::string& name, Getter get) {
+    DataArray array;
+    array.type               = type;
+    array.name               = name;
+    array.numberOfComponents = 1;
+    array.bytesPerTuple      = sizeof(T);
+    // unary plus prints 8-bit integers as numbers, not as characters
+    array.writeAscii  = [get](size_t i, std::ostream& os) { os << +static_cast<T>(get(i)); };
+    array.writeBinary = [get](size_t begin, size_t end, char* out) {
+        for (size_t i = begin; i < end; i++) {
+            T value = static_cast<T>(get(i));
+            std::memcpy(out + (i - begin) * sizeof(T), &value, sizeof(T));
+        }
+    };
+    return array;
+}
+
+template <typename Getter>
+ParticlesExporter::DataArray ParticlesExporter::vectorArray(const std::string& name, Getter get) {
+    DataArray array;
+    array.type               = "Float64";
+    array.name               = name;
+    array.numberOfComponents = 3;
+    array.bytesPerTuple      = 3 * sizeof(double);
+    array.writeAscii         = [get](size_t i, std::ostream& os) {
+        const Eigen::Vector3d& v = get(i);
+        os << v.x() << " " << v.y() << " " << v.z();
+    };
+    array.writeBinary = [get](size_t begin, size_t end, char* out) {
+        for (size_t i = begin; i < end; i++) {
+            const Eigen::Vector3d& v = get(i);
+            double xyz[3]            = {v.x(), v.y(), v.z()};
+            std::memcpy(out + (i - begin) * sizeof(xyz), xyz, sizeof(xyz));
+        }
+    };
+    return array;
+}
+
+std::vector<ParticlesExporter::DataArray> ParticlesExporter::pointDataArrays(const double& n0ForNumberDensity) const {
+    const ParticlesView& ps = particles;
+    std::vector<DataArray> arrays;
+    if (exportsField(ParticleField::Type)) {
+        arrays.push_back(scalarArray<int32_t>("Int32", "Particle Type", [&ps](size_t i) { return ps.type(i); }));
+    }
+    if (exportsField(ParticleField::Velocity)) {
+        arrays.push_back(vectorArray("Velocity", [&ps](size_t i) -> const Eigen::Vector3d& { return ps.velocity(i); }));
+    }
+    if (exportsField(ParticleField::Pressure)) {
+        arrays.push_back(scalarArray<double>("Float64", "Pressure", [&ps](size_t i) { return ps.pressure(i); }));
+    }
+    if (exportsField(ParticleField::NumberDensity)) {
+        arrays.push_back(scalarArray<double>("Float64", "Number Density", [&ps](size_t i) {
+            return ps.numberDensity(i);
+        }));
+        arrays.push_back(scalarArray<double>("Float64", "Number Density Ratio", [&ps, n0ForNumberDensity](size_t i) {
+            return ps.numberDensity(i) / n0ForNumberDensity;
+        }));
+    }
+    if (exportsField(ParticleField::BoundaryCondition)) {
+        arrays.push_back(scalarArray<int32_t>("Int32", "Boundary Condition", [&ps](size_t i) {
+            return ps.boundaryCondition(i);
+        }));
+    }
+    if (exportsField(ParticleField::FluidType)) {
+        arrays.push_back(scalarArray<int32_t>("Int32", "Fluid Type", [&ps](size_t i) { return ps.fluidType(i); }));
+    }
+    if (exportsField(ParticleField::OriginalId)) {
+        arrays.push_back(scalarArray<int32_t>("Int32", "Original Id", [&ps](size_t i) { return ps.originalId(i); }));
+    }
+    return arrays;
+}
+
+std::vector<ParticlesExporter::DataArray> ParticlesExporter::cellArrays() const {
+    if (!writesCells)
+        return {};
+
+    // Int32 is enough for the connectivity and the offsets unless there are more than 2^31-1 particles
+    if (particles.size() <= static_cast<size_t>(INT32_MAX)) {
+        return {
+            scalarArray<int32_t>("Int32", "connectivity", [](size_t i) { return i; }),
+            scalarArray<int32_t>("Int32", "offsets", [](size_t i) { return i + 1; }),
+            scalarArray<uint8_t>("UInt8", "types", [](size_t) { return 1; }), // 1: vertex
+        };
+    }
+    return {
+        scalarArray<int64_t>("Int64", "connectivity", [](size_t i) { return i; }),
+        scalarArray<int64_t>("Int64", "offsets", [](size_t i) { return i + 1; }),
+        scalarArray<uint8_t>("UInt8", "types", [](size_t) { return 1; }), // 1: vertex
+    };
+}
+
+size_t ParticlesExporter::numberOfCells() const {
+    return writesCells ? particles.size() : 0;
+}
+
+void ParticlesExporter::writeAscii(std::ostream& os, const DataArray& array) const {
+    os << dataArrayBegin(array.type, array.name, array.numberOfComponents, "ascii") << endl;
+    for (size_t i = 0; i < particles.size(); i++) {
+        array.writeAscii(i, os);
+        os << endl;
+    }
+    os << dataArrayEnd() << endl;
+}
+
+void ParticlesExporter::writeAppended(std::ostream& os, const DataArray& array) const {
+    uint64_t length = particles.size() * array.bytesPerTuple;
+    os.write(reinterpret_cast<char*>(&length), sizeof(uint64_t));
+
+    // convert the particles chunk by chunk so that the memory used for the conversion does not depend on their number
+    constexpr size_t chunkSize = 4096;
+    std::vector<char> buffer(chunkSize * array.bytesPerTuple);
+    for (size_t begin = 0; begin < particles.size(); begin += chunkSize) {
+        size_t end = std::min(begin + chunkSize, particles.size());
+        array.writeBinary(begin, end, buffer.data());
+        os.write(buffer.data(), (end - begin) * array.bytesPerTuple);
+    }
+}
+
+bool ParticlesExporter::compressArrays(const std::vector<DataArray>& arrays, std::vector<std::string>& appendedData)
+    const {
+    // Each block contains whole tuples, so that it can be converted independently of the other blocks.
+    struct Block {
+        size_t array;
+        size_t begin; ///< first tuple in the block
+        size_t end;   ///< one past the last tuple in the block
+        std::string compressed;
+    };
+    std::vector<Block> blocks;
+    for (size_t a = 0; a < arrays.size(); a++) {
+        size_t tuplesPerBlock = std::max<size_t>(1, zlibBlockSize / arrays[a].bytesPerTuple);
+        for (size_t begin = 0; begin < particles.size(); begin += tuplesPerBlock) {
+            blocks.push_back({a, begin, std::min(begin + tuplesPerBlock, particles.size()), ""});
+        }
+    }
+
+    bool failed = false;
+#pragma omp parallel
+    {
+        std::vector<char> buffer;
+#pragma omp for schedule(dynamic)
+        for (int b = 0; b < static_cast<int>(blocks.size()); b++) {
+            Block& block          = blocks[b];
+            const auto& array     = arrays[block.array];
+            size_t size           = (block.end - block.begin) * array.bytesPerTuple;
+            uLongf compressedSize = compressBound(size);
+            buffer.resize(size);
+            array.writeBinary(block.begin, block.end, buffer.data());
+            block.compressed.resize(compressedSize);
+            int result = compress2(
+                reinterpret_cast<Bytef*>(block.compressed.data()),
+                &compressedSize,
+                reinterpret_cast<const Bytef*>(buffer.data()),
+                size,
+                zlibCompressionLevel
+            );
+            if (result != Z_OK) {
+#pragma omp atomic write
+                failed = true;
+            }
+            block.compressed.resize(compressedSize);
+        }
+    }
+    if (failed) {
+        cerr << "ERROR: failed to compress data by zlib." << endl;
+        return false;
+    }
+
+    // blocks are ordered by array
+    appendedData.clear();
+    size_t b = 0;
+    for (size_t a = 0; a < arrays.size(); a++) {
+        size_t tuplesPerBlock = std::max<size_t>(1, zlibBlockSize / arrays[a].bytesPerTuple);
+        size_t blockSize      = tuplesPerBlock * arrays[a].bytesPerTuple;
+        size_t lastBlockSize  = blockSize;
+        std::vector<std::string> compressedBlocks;
+        for (; b < blocks.size() && blocks[b].array == a; b++) {
+            compressedBlocks.push_back(std::move(blocks[b].compressed));
+            lastBlockSize = (blocks[b].end - blocks[b].begin) * arrays[a].bytesPerTuple;
+        }
+        appendedData.push_back(zlibAppendedData(compressedBlocks, blockSize, lastBlockSize));
+    }
+    return true;
+}
+
+bool ParticlesExporter::compressBytes(const char* data, size_t size, std::string& appendedData) {
+    uLongf compressedSize = compressBound(size);
+    std::string block(compressedSize, '\0');
+    int result = compress2(
+        reinterpret_cast<Bytef*>(block.data()),
+        &compressedSize,
+        reinterpret_cast<const Bytef*>(data),
+        size,
+        zlibCompressionLevel
+    );
+    if (result != Z_OK) {
+        cerr << "ERROR: failed to compress data by zlib." << endl;
+        return false;
+    }
+    block.resize(compressedSize);
+    appendedData = zlibAppendedData({block}, size, size);
+    return true;
+}
+
+std::string
+ParticlesExporter::zlibAppendedData(const std::vector<std::string>& blocks, size_t blockSize, size_t lastBlockSize) {
+    // header: number of blocks, size of a block, size of the last block (0 if it is full) and compressed sizes
+    std::vector<uint64_t> header = {blocks.size(), blockSize, (lastBlockSize == blockSize) ? 0 : lastBlockSize};
+    for (const auto& block : blocks) {
+        header.push_back(block.size());
+    }
+
+    std::string data(reinterpret_cast<const char*>(header.data()), header.size() * sizeof(uint64_t));
+    for (const auto& block : blocks) {
+        data += block;
+    }
+    return data;
+}
+
+bool ParticlesExporter::exportsField(const ParticleField& field) const {
+    return std::find(fields.begin(), fields.end(), field) != fields.end();
+}
+
+bool ParticlesExporter::hasFields() const {
+    bool hasAll = true;
+    for (const auto& field : fields) {
+        if (particles.size() > 0 && !particles.has(field)) {
+            cerr << "ERROR: the field " << static_cast<int>(field) << " to export is not in the particles." << endl;
+            hasAll = false;
+        }
+    }
+    return hasAll;
+}
+
+bool ParticlesExporter::requireField(const ParticleField& field, const std::string& format) const {
+    if (particles.size() > 0 && !particles.has(field)) {
+        cerr << "ERROR: the field " << static_cast<int>(field) << " required by " << format
+             << " format is not in the particles." << endl;
+        return false;
+    }
+    return true;
+}
+
 void ParticlesExporter::setParticles(const Particles& particles) {
+    this->particles = ParticlesView(particles);
+}
+
+void ParticlesExporter::setParticles(const ParticlesView& particles) {
     this->particles = particles;
 }
 
-void ParticlesExporter::toProf(const fs::path& path, const double& time) {
+void ParticlesExporter::setFields(const std::vector<ParticleField>& fields) {
+    this->fields = fields;
+}
+
+void ParticlesExporter::setWritesCells(const bool writesCells) {
+    this->writesCells = writesCells;
+}
+
+bool ParticlesExporter::toProf(const fs::path& path, const double& time) {
+    if (!requireField(ParticleField::Type, "Prof") || !requireField(ParticleField::Velocity, "Prof"))
+        return false;
+
     std::ofstream ofs(path);
     if (ofs.fail()) {
         cerr << "cannot write " << path << endl;
-        std::exit(-1);
+        return false;
     }
 
     ofs << time << endl;
     ofs << particles.size() << endl;
-    for (const auto& p : particles) {
-        ofs << static_cast<int>(p.type) << " ";
-        ofs << p.position.x() << " " << p.position.y() << " " << p.position.z() << " ";
-        ofs << p.velocity.x() << " " << p.velocity.y() << " " << p.velocity.z();
+    for (size_t i = 0; i < particles.size(); i++) {
+        const Eigen::Vector3d& r = particles.position(i);
+        const Eigen::Vector3d& u = particles.velocity(i);
+        ofs << static_cast<int>(particles.type(i)) << " ";
+        ofs << r.x() << " " << r.y() << " " << r.z() << " ";
+        ofs << u.x() << " " << u.y() << " " << u.z();
         ofs << endl;
     }
+    ofs.close();
+    return !ofs.fail();
 }
-void ParticlesExporter::toVtuAscii(const fs::path& path, const double& time, const double& n0ForNumberDensity) {
+
+bool ParticlesExporter::toVtuAscii(const fs::path& path, const double& time, const double& n0ForNumberDensity) {
+    if (!hasFields())
+        return false;
+
     std::ofstream ofs(path);
     if (ofs.fail()) {
         cerr << "cannot write " << path << endl;
-        std::exit(-1);
+        return false;
     }
 
     // header
@@ -82,90 +352,37 @@ void ParticlesExporter::toVtuAscii(const fs::path& path, const double& time, con
     }
     ofs << "\">" << endl;
     ofs << "<UnstructuredGrid>" << endl
-        << "<Piece NumberOfPoints=\"" << particles.size() << "\" NumberOfCells=\"" << particles.size() << "\">" << endl;
+        << "<Piece NumberOfPoints=\"" << particles.size() << "\" NumberOfCells=\"" << numberOfCells() << "\">" << endl;
 
     /// ------------------
     /// ----- Points -----
     /// ------------------
+    const ParticlesView& ps = particles;
     ofs << "<Points>" << endl;
-    ofs << dataArrayBegin("Float64", "Position", 3, "ascii") << endl;
-    for (const auto& p : particles) {
-        ofs << p.position.x() << " " << p.position.y() << " " << p.position.z() << endl;
-    }
-    ofs << dataArrayEnd() << endl;
+    writeAscii(ofs, vectorArray("Position", [&ps](size_t i) -> const Eigen::Vector3d& { return ps.position(i); }));
     ofs << "</Points>" << endl;
 
     // ---------------------
     // ----- PointData -----
     // ---------------------
     ofs << "<PointData>" << endl;
-    // Particle Type
-    ofs << dataArrayBegin("Int32", "Particle Type", 1, "ascii") << endl;
-    for (const auto& p : particles) {
-        ofs << static_cast<int32_t>(p.type) << endl;
-    }
-    ofs << dataArrayEnd() << endl;
-    // Velocity
-    ofs << dataArrayBegin("Float64", "Velocity", 3, "ascii") << endl;
-    for (const auto& p : particles) {
-        ofs << p.velocity.x() << " " << p.velocity.y() << " " << p.velocity.z() << endl;
-    }
-    ofs << dataArrayEnd() << endl;
-    // Pressure
-    ofs << dataArrayBegin("Float64", "Pressure", 1, "ascii") << endl;
-    for (const auto& p : particles) {
-        ofs << p.pressure << endl;
-    }
-    ofs << dataArrayEnd() << endl;
-    // Number Density
-    ofs << dataArrayBegin("Float64", "Number Density", 1, "ascii") << endl;
-    for (const auto& p : particles) {
-        ofs << p.numberDensity << endl;
-    }
-    ofs << dataArrayEnd() << endl;
-    // Number Density Ratio
-    ofs << dataArrayBegin("Float64", "Number Density Ratio", 1, "ascii") << endl;
-    for (const auto& p : particles) {
-        ofs << p.numberDensity / n0ForNumberDensity << endl;
+    for (const auto& array : pointDataArrays(n0ForNumberDensity)) {
+        writeAscii(ofs, array);
     }
-    ofs << dataArrayEnd() << endl;
-    // Boundary Condition
-    ofs << dataArrayBegin("Int32", "Boundary Condition", 1, "ascii") << endl;
-    for (const auto& p : particles) {
-        ofs << static_cast<int32_t>(p.boundaryCondition) << endl;
-    }
-    ofs << dataArrayEnd() << endl;
-    // Fluid Type
-    ofs << dataArrayBegin("Int32", "Fluid Type", 1, "ascii") << endl;
-    for (const auto& p : particles) {
-        ofs << p.fluidType << endl;
-    }
-    ofs << dataArrayEnd() << endl;
     ofs << "</PointData>" << endl;
 
     /// -----------------
     /// ----- Cells -----
     /// -----------------
-    ofs << "<Cells>" << endl;
-    // connectivity
-    ofs << dataArrayBegin("Int64", "connectivity", 1, "ascii") << endl;
-    for (size_t i = 0; i < particles.size(); i++) {
-        ofs << i << endl;
+    // the Cells element is omitted when there are no cells
+    std::vector<DataArray> cells = cellArrays();
+    if (!cells.empty()) {
+        ofs << "<Cells>" << endl;
+        for (const auto& array : cells) {
+            writeAscii(ofs, array);
+        }
+        ofs << "</Cells>" << endl;
     }
-    ofs << dataArrayEnd() << endl;
-    // offsets
-    ofs << dataArrayBegin("Int64", "offsets", 1, "ascii") << endl;
-    for (size_t i = 0; i < particles.size(); i++) {
-        ofs << i + 1 << endl;
-    }
-    ofs << dataArrayEnd() << endl;
-    // types
-    ofs << dataArrayBegin("UInt8", "types", 1, "ascii") << endl;
-    for (const auto& p : particles) {
-        ofs << 1 << endl; // 1: particle
-    }
-    ofs << dataArrayEnd() << endl;
-    ofs << "</Cells>" << endl;
     ofs << "</Piece>" << endl;
     // ---------------------
     // ---- Field data  ----
@@ -177,16 +394,65 @@ void ParticlesExporter::toVtuAscii(const fs::path& path, const double& time, con
     ofs << "</FieldData>" << endl;
     ofs << "</UnstructuredGrid>" << endl;
     ofs << "</VTKFile>" << endl;
+    ofs.close();
+    return !ofs.fail();
 }
 
-void ParticlesExporter::toVtuBinary(const fs::path& path, const double& time, const double& n0ForNumberDensity) {
-    std::ofstream ofs(path);
+bool ParticlesExporter::toVtuBinary(
+    const fs::path& path, const double& time, const double& n0ForNumberDensity, const bool compressed
+) {
+    std::ofstream ofs(path, std::ios::binary);
     if (ofs.fail()) {
         cerr << "cannot write " << path << endl;
-        std::exit(-1);
+        return false;
+    }
+    if (!writeVtuBinary(ofs, time, n0ForNumberDensity, compressed))
+        return false;
+    ofs.close();
+    return !ofs.fail();
+}
+
+bool ParticlesExporter::writeVtuBinary(
+    std::ostream& ofs, const double& time, const double& n0ForNumberDensity, const bool compressed
+) {
+    if (!hasFields())
+        return false;
+
+    const ParticlesView& ps = particles;
+    DataArray positionArray =
+        vectorArray("Position", [&ps](size_t i) -> const Eigen::Vector3d& { return ps.position(i); });
+    std::vector<DataArray> pointData = pointDataArrays(n0ForNumberDensity);
+    std::vector<DataArray> cells     = cellArrays();
+
+    // arrays in the order of the appended data
+    std::vector<DataArray> arrays = {positionArray};
+    arrays.insert(arrays.end(), pointData.begin(), pointData.end());
+    arrays.insert(arrays.end(), cells.begin(), cells.end());
+
+    // Compressed data are kept in memory since their sizes are needed for the offsets before they are written.
+    // Uncompressed data are converted while they are written.
+    std::vector<std::string> compressedArrays;
+    std::string compressedTime;
+    if (compressed) {
+        if (!compressArrays(arrays, compressedArrays))
+            return false;
+        if (!compressBytes(reinterpret_cast<const char*>(&time), sizeof(double), compressedTime))
+            return false;
     }
 
-    std::stringstream binaryData; // binary data to be written
+    // The data are written after the XML part, so the offset of each array in the appended data is calculated first.
+    size_t offset          = 0;
+    size_t arrayIndex      = 0;
+    auto appendedDataBegin = [&](const DataArray& array) {
+        std::string begin = dataArrayBegin(array.type, array.name, array.numberOfComponents, "appended", offset);
+        if (compressed) {
+            offset += compressedArrays[arrayIndex].size();
+        } else {
+            offset += sizeof(uint64_t) + particles.size() * array.bytesPerTuple;
+        }
+        arrayIndex++;
+        return begin;
+    };
 
     // header
     ofs << "<?xml version='1.0' encoding='UTF-8'?>" << endl;
@@ -196,178 +462,119 @@ void ParticlesExporter::toVtuBinary(const fs::path& path, const double& time, co
     } else {
         ofs << "LittleEndian";
     }
-    ofs << "\">" << endl;
+    ofs << "\"";
+    if (compressed) {
+        ofs << " compressor=\"vtkZLibDataCompressor\"";
+    }
+    ofs << ">" << endl;
     ofs << "<UnstructuredGrid>" << endl
-        << "<Piece NumberOfPoints=\"" << particles.size() << "\" NumberOfCells=\"" << particles.size() << "\">" << endl;
+        << "<Piece NumberOfPoints=\"" << particles.size() << "\" NumberOfCells=\"" << numberOfCells() << "\">" << endl;
     /// ------------------
     /// ----- Points -----
     /// ------------------
     ofs << "<Points>" << endl;
-    ofs << dataArrayBegin("Float64", "Position", 3, "appended", binaryData.tellp()) << endl;
+    ofs << appendedDataBegin(positionArray) << endl;
     ofs << dataArrayEnd() << endl;
-    uint64_t length_points = particles.size() * 3 * sizeof(double);
-    binaryData.write(reinterpret_cast<char*>(&length_points), sizeof(uint64_t));
-    for (const auto& p : particles) {
-        double x = p.position.x();
-        double y = p.position.y();
-        double z = p.position.z();
-        binaryData.write(reinterpret_cast<char*>(&x), sizeof(double));
-        binaryData.write(reinterpret_cast<char*>(&y), sizeof(double));
-        binaryData.write(reinterpret_cast<char*>(&z), sizeof(double));
-    }
     ofs << "</Points>" << endl;
     // ---------------------
     // ----- PointData -----
     // ---------------------
     ofs << "<PointData>" << endl;
-    // Particle Type
-    ofs << dataArrayBegin("Int32", "Particle Type", 1, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_particle_type = particles.size() * sizeof(int32_t);
-    binaryData.write(reinterpret_cast<char*>(&length_particle_type), sizeof(uint64_t));
-    for (const auto& p : particles) {
-        int32_t type = static_cast<int32_t>(p.type);
-        binaryData.write(reinterpret_cast<char*>(&type), sizeof(int32_t));
-    }
-    // Velocity
-    ofs << dataArrayBegin("Float64", "Velocity", 3, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_velocity = particles.size() * 3 * sizeof(double);
-    binaryData.write(reinterpret_cast<char*>(&length_velocity), sizeof(uint64_t));
-    for (const auto& p : particles) {
-        double vx = p.velocity.x();
-        double vy = p.velocity.y();
-        double vz = p.velocity.z();
-        binaryData.write(reinterpret_cast<char*>(&vx), sizeof(double));
-        binaryData.write(reinterpret_cast<char*>(&vy), sizeof(double));
-        binaryData.write(reinterpret_cast<char*>(&vz), sizeof(double));
-    }
-    // Pressure
-    ofs << dataArrayBegin("Float64", "Pressure", 1, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_pressure = particles.size() * sizeof(double);
-    binaryData.write(reinterpret_cast<char*>(&length_pressure), sizeof(uint64_t));
-    for (const auto& p : particles) {
-        double pressure = p.pressure;
-        binaryData.write(reinterpret_cast<char*>(&pressure), sizeof(double));
-    }
-    // Number Density
-    ofs << dataArrayBegin("Float64", "Number Density", 1, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_number_density = particles.size() * sizeof(double);
-    binaryData.write(reinterpret_cast<char*>(&length_number_density), sizeof(uint64_t));
-    for (const auto& p : particles) {
-        double number_density = p.numberDensity;
-        binaryData.write(reinterpret_cast<char*>(&number_density), sizeof(double));
-    }
-    // Number Density Ratio
-    ofs << dataArrayBegin("Float64", "Number Density Ratio", 1, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_number_density_ratio = particles.size() * sizeof(double);
-    binaryData.write(reinterpret_cast<char*>(&length_number_density_ratio), sizeof(uint64_t));
-    for (const auto& p : particles) {
-        double number_density_ratio = p.numberDensity / n0ForNumberDensity;
-        binaryData.write(reinterpret_cast<char*>(&number_density_ratio), sizeof(double));
-    }
-    // Boundary Condition
-    ofs << dataArrayBegin("Int32", "Boundary Condition", 1, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_boundary_condition = particles.size() * sizeof(int32_t);
-    binaryData.write(reinterpret_cast<char*>(&length_boundary_condition), sizeof(uint64_t));
-    for (const auto& p : particles) {
-        int32_t boundary_condition = static_cast<int32_t>(p.boundaryCondition);
-        binaryData.write(reinterpret_cast<char*>(&boundary_condition), sizeof(int32_t));
-    }
-    // Fluid Type
-    ofs << dataArrayBegin("Int32", "Fluid Type", 1, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_fluid_type = particles.size() * sizeof(int32_t);
-    binaryData.write(reinterpret_cast<char*>(&length_fluid_type), sizeof(uint64_t));
-    for (const auto& p : particles) {
-        int32_t fluid_type = p.fluidType;
-        binaryData.write(reinterpret_cast<char*>(&fluid_type), sizeof(int32_t));
+    for (const auto& array : pointData) {
+        ofs << appendedDataBegin(array) << endl;
+        ofs << dataArrayEnd() << endl;
     }
     ofs << "</PointData>" << endl;
     /// ------------------
     /// ----- Cells -----
     /// ------------------
-    ofs << "<Cells>" << endl;
-    // connectivity
-    ofs << dataArrayBegin("Int64", "connectivity", 1, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_connectivity = particles.size() * sizeof(int64_t);
-    binaryData.write(reinterpret_cast<char*>(&length_connectivity), sizeof(uint64_t));
-    for (size_t i = 0; i < particles.size(); i++) {
-        int64_t connectivity = i;
-        binaryData.write(reinterpret_cast<char*>(&connectivity), sizeof(int64_t));
-    }
-    // offsets
-    ofs << dataArrayBegin("Int64", "offsets", 1, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_offset = particles.size() * sizeof(int64_t);
-    binaryData.write(reinterpret_cast<char*>(&length_offset), sizeof(uint64_t));
-    for (size_t i = 0; i < particles.size(); i++) {
-        int64_t offset = i + 1;
-        binaryData.write(reinterpret_cast<char*>(&offset), sizeof(int64_t));
+    if (!cells.empty()) {
+        ofs << "<Cells>" << endl;
+        for (const auto& array : cells) {
+            ofs << appendedDataBegin(array) << endl;
+            ofs << dataArrayEnd() << endl;
+        }
+        ofs << "</Cells>" << endl;
     }
-    // types
-    ofs << dataArrayBegin("UInt8", "types", 1, "appended", binaryData.tellp()) << endl;
-    ofs << dataArrayEnd() << endl;
-    uint64_t length_types = particles.size() * sizeof(uint8_t);
-    binaryData.write(reinterpret_cast<char*>(&length_types), sizeof(uint64_t));
-    for (const auto& p : particles) {
-        uint8_t type = 1; // 1: particle
-        binaryData.write(reinterpret_cast<char*>(&type), sizeof(uint8_t));
-    }
-    ofs << "</Cells>" << endl;
     ofs << "</Piece>" << endl;
     // ---------------------
     // ---- Field data  ----
     // ---------------------
     ofs << "<FieldData>" << endl;
-    ofs << "<DataArray type=\"Float64\" Name=\"Time\" NumberOfTuples=\"1\" format=\"appended\" offset=\""
-        << binaryData.tellp() << "\"/>" << endl;
-    // Time
-    uint64_t length_time = sizeof(double);
-    binaryData.write(reinterpret_cast<char*>(&length_time), sizeof(uint64_t));
-    double time_copied = time; // copy time to use reinterpret_cast
-    binaryData.write(reinterpret_cast<char*>(&time_copied), sizeof(double));
+    ofs << "<DataArray type=\"Float64\" Name=\"Time\" NumberOfTuples=\"1\" format=\"appended\" offset=\"" << offset
+        << "\"/>" << endl;
     ofs << "</FieldData>" << endl;
     ofs << "</UnstructuredGrid>" << endl;
     // ---------------------
     // --- Appended Data ---
     // ---------------------
     ofs << "<AppendedData encoding=\"raw\">" << endl;
-    ofs << "_" << binaryData.str() << endl;
+    ofs << "_";
+    if (compressed) {
+        for (const auto& data : compressedArrays) {
+            ofs.write(data.data(), data.size());
+        }
+        ofs.write(compressedTime.data(), compressedTime.size());
+    } else {
+        for (const auto& array : arrays) {
+            writeAppended(ofs, array);
+        }
+        // Time
+        uint64_t length_time = sizeof(double);
+        ofs.write(reinterpret_cast<char*>(&length_time), sizeof(uint64_t));
+        double time_copied = time; // copy time to use reinterpret_cast
+        ofs.write(reinterpret_cast<char*>(&time_copied), sizeof(double));
+    }
+    ofs << endl;
     ofs << "</AppendedData>" << endl;
     ofs << "</VTKFile>" << endl;
+    return true;
 }
 
-void ParticlesExporter::toVtu(
-    const std::filesystem::path& path, const double& time, const double& n0ForNumberDensity, const bool binary
+bool ParticlesExporter::toVtu(
+    const std::filesystem::path& path,
+    const double& time,
+    const double& n0ForNumberDensity,
+    const bool binary,
+    const bool compressed
 ) {
     if (binary) {
-        toVtuBinary(path, time, n0ForNumberDensity);
-    } else {
-        toVtuAscii(path, time, n0ForNumberDensity);
+        return toVtuBinary(path, time, n0ForNumberDensity, compressed);
     }
+    return toVtuAscii(path, time, n0ForNumberDensity);
+}
+
+bool ParticlesExporter::toVtuSeries(
+    VtuSeries& series, const double& time, const double& n0ForNumberDensity, const bool compressed
+) {
+    if (!writeVtuBinary(series.beginFrame(), time, n0ForNumberDensity, compressed))
+        return false;
+    return series.endFrame(time, particles.size());
 }
 
-void ParticlesExporter::toCsv(const fs::path& path, const double& time) {
+bool ParticlesExporter::toCsv(const fs::path& path, const double& time) {
+    if (!requireField(ParticleField::Type, "CSV") || !requireField(ParticleField::FluidType, "CSV") ||
+        !requireField(ParticleField::Velocity, "CSV"))
+        return false;
+
     std::ofstream ofs(path);
     if (ofs.fail()) {
         cerr << "cannot write " << path << endl;
-        std::exit(-1);
+        return false;
     }
 
     ofs << time << endl;
     ofs << particles.size() << endl;
     ofs << "type,fluidType,x,y,z,vx,vy,vz" << endl;
-    for (const auto& p : particles) {
-        ofs << static_cast<int>(p.type) << ",";
-        ofs << p.fluidType << ",";
-        ofs << p.position.x() << "," << p.position.y() << "," << p.position.z() << ",";
-        ofs << p.velocity.x() << "," << p.velocity.y() << "," << p.velocity.z();
+    for (size_t i = 0; i < particles.size(); i++) {
+        const Eigen::Vector3d& r = particles.position(i);
+        const Eigen::Vector3d& u = particles.velocity(i);
+        ofs << static_cast<int>(particles.type(i)) << ",";
+        ofs << particles.fluidType(i) << ",";
+        ofs << r.x() << "," << r.y() << "," << r.z() << ",";
+        ofs << u.x() << "," << u.y() << "," << u.z();
         ofs << endl;
     }
+    ofs.close();
+    return !ofs.fail();
 }
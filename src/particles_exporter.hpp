@@ -1,10 +1,16 @@
 #pragma once
 
 #include "common.hpp"
+#include "particle_field.hpp"
 #include "particles.hpp"
+#include "particles_view.hpp"
+#include "vtu_series.hpp"
 
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <ostream>
+#include <string>
 #include <vector>
 
 /**
@@ -15,6 +21,10 @@
  * file format, you can add a new method to this class. It only requires
  * the particles (and the time) to export the particles to a file.
  *
+ * The export methods report failures to the standard error and return false
+ * instead of exiting, since they may be run in the writer thread of
+ * OutputWriter, which passes the failure to the thread of the simulation.
+ *
  */
 class ParticlesExporter {
 private:
@@ -44,43 +54,168 @@ private:
     /// @return the end of the DataArray
     std::string dataArrayEnd() const;
 
-    /// @brief Export the particles to a file in the VTK zlib format.
+    /// @brief data array of the VTK format
+    struct DataArray {
+        std::string type;       ///< type of data (e.g., Float64, Int32)
+        std::string name;       ///< name of the data array
+        int numberOfComponents; ///< number of components of the data array
+        size_t bytesPerTuple;   ///< size of the components of a particle in bytes
+        /// @brief write the components of a particle in ascii
+        std::function<void(size_t i, std::ostream& os)> writeAscii;
+        /// @brief write the components of the particles in [begin, end) in binary to out
+        std::function<void(size_t begin, size_t end, char* out)> writeBinary;
+    };
+
+    /// @brief data array of a scalar field
+    /// @tparam T type of the values written to the file
+    /// @param type VTK type corresponding to T
+    /// @param name name of the data array
+    /// @param get function that returns the value of the i-th particle
+    template <typename T, typename Getter>
+    static DataArray scalarArray(const std::string& type, const std::string& name, Getter get);
+
+    /// @brief data array of a 3D vector field of Float64
+    /// @param name name of the data array
+    /// @param get function that returns the vector of the i-th particle
+    template <typename Getter> static DataArray vectorArray(const std::string& name, Getter get);
+
+    /// @brief data arrays in PointData of the VTK format
+    /// @param n0ForNumberDensity reference number density for the number density calculation
+    std::vector<DataArray> pointDataArrays(const double& n0ForNumberDensity) const;
+
+    /// @brief data arrays in Cells of the VTK format. Each particle is a vertex cell.
+    /// @return empty if the cells are not written
+    std::vector<DataArray> cellArrays() const;
+
+    /// @brief number of cells in the VTK format
+    size_t numberOfCells() const;
+
+    /// @brief write a data array in ascii format
+    void writeAscii(std::ostream& os, const DataArray& array) const;
+
+    /// @brief write a data array in the raw appended format (size of the data followed by the data)
+    void writeAppended(std::ostream& os, const DataArray& array) const;
+
+    /// @brief size of uncompressed blocks in the zlib compressed format in bytes (same as the default of VTK)
+    static constexpr size_t zlibBlockSize = 32768;
+
+    /// @brief compression level of zlib. The fastest level is used since the files are written during the simulation.
+    static constexpr int zlibCompressionLevel = 1;
+
+    /// @brief compress the data arrays by zlib in parallel over all the blocks of all the arrays
+    /// @param appendedData appended data of each array in the format of vtkZLibDataCompressor (header followed by the
+    /// blocks)
+    /// @return whether the arrays have been compressed
+    bool compressArrays(const std::vector<DataArray>& arrays, std::vector<std::string>& appendedData) const;
+
+    /// @brief compress data by zlib as a single block
+    /// @param appendedData appended data in the format of vtkZLibDataCompressor (header followed by the block)
+    /// @return whether the data have been compressed
+    static bool compressBytes(const char* data, size_t size, std::string& appendedData);
+
+    /// @brief build the appended data of vtkZLibDataCompressor from compressed blocks
+    /// @param blocks compressed blocks
+    /// @param blockSize uncompressed size of the blocks but the last one
+    /// @param lastBlockSize uncompressed size of the last block
+    static std::string zlibAppendedData(const std::vector<std::string>& blocks, size_t blockSize, size_t lastBlockSize);
+
+    /// @brief whether the field is in the field list
+    bool exportsField(const ParticleField& field) const;
+
+    /// @brief whether the particles have all the fields in the field list. The missing ones are reported.
+    bool hasFields() const;
+
+    /// @brief whether the particles have the field required by a file format. It is reported if they do not.
+    bool requireField(const ParticleField& field, const std::string& format) const;
+
+    /// @brief Export the particles to a file in the VTK ascii format.
     /// @param path path to the file to write
     /// @param time current time in the simulation
     /// @param n0ForNumberDensity reference number density for the number density calculation
-    void toVtuAscii(const std::filesystem::path& path, const double& time, const double& n0ForNumberDensity = 1.0);
+    /// @return whether the file has been written
+    bool toVtuAscii(const std::filesystem::path& path, const double& time, const double& n0ForNumberDensity = 1.0);
 
-    /// @brief Export the particles to a file in the VTK zlib format.
+    /// @brief Export the particles to a file in the VTK binary (appended) format.
     /// @param path path to the file to write
     /// @param time current time in the simulation
     /// @param n0ForNumberDensity reference number density for the number density calculation
-    void toVtuBinary(const std::filesystem::path& path, const double& time, const double& n0ForNumberDensity = 1.0);
+    /// @param compressed if true, the data are compressed by zlib. Otherwise they are written as they are (raw).
+    /// @return whether the file has been written
+    bool toVtuBinary(
+        const std::filesystem::path& path,
+        const double& time,
+        const double& n0ForNumberDensity = 1.0,
+        const bool compressed            = false
+    );
+
+    /// @brief write the particles in the VTK binary (appended) format to a stream
+    /// @param ofs stream to write to
+    /// @param time current time in the simulation
+    /// @param n0ForNumberDensity reference number density for the number density calculation
+    /// @param compressed if true, the data are compressed by zlib. Otherwise they are written as they are (raw).
+    /// @return whether the data have been written
+    bool writeVtuBinary(std::ostream& ofs, const double& time, const double& n0ForNumberDensity, const bool compressed);
 
 public:
-    Particles particles;
+    ParticlesView particles;                                 ///< view of the particles to export
+    std::vector<ParticleField> fields = allParticleFields(); ///< fields written in the VTK format
+    bool writesCells                  = true;                ///< whether a vertex cell per particle is written in VTK
 
     /// @brief Set the particles to export to a file. This method is required before exporting.
+    /// @details The particles are not copied, so they must not be changed or destroyed until the files are written.
     /// @param particles
     void setParticles(const Particles& particles);
 
+    /// @brief Set the particles to export to a file. This method is required before exporting.
+    /// @param particles view of the particles, e.g. of a ParticlesSnapshot
+    void setParticles(const ParticlesView& particles);
+
+    /// @brief Set the fields written in the VTK format. All the fields are written by default.
+    /// @details The position is always written. The Prof and CSV formats always contain the fields needed to load the
+    /// particles again (type, velocity and, for CSV, fluid type).
+    /// @param fields fields to write
+    void setFields(const std::vector<ParticleField>& fields);
+
+    /// @brief Set whether a vertex cell per particle is written in the VTK format. They are written by default.
+    /// @details Without the cells, the files are smaller and faster to write, but ParaView shows the particles only in
+    /// the representations that use the points directly, such as Point Gaussian.
+    /// @param writesCells whether the cells are written
+    void setWritesCells(const bool writesCells);
+
     /// @brief Export the particles to a file in the Prof format.
     /// @param path path to the file to write
     /// @param time current time in the simulation
-    void toProf(const std::filesystem::path& path, const double& time);
+    /// @return whether the file has been written
+    bool toProf(const std::filesystem::path& path, const double& time);
 
-    /// @brief Export the particles to a file in the VTK zlib format.
+    /// @brief Export the particles to a file in the VTK format.
     /// @param path path to the file to write
     /// @param time current time in the simulation
     /// @param n0ForNumberDensity reference number density for the number density calculation
-    void toVtu(
+    /// @param binary if true, the data are written in binary (appended), otherwise in ascii
+    /// @param compressed if true, the binary data are compressed by zlib (vtkZLibDataCompressor). Ignored for ascii.
+    /// @return whether the file has been written
+    bool toVtu(
         const std::filesystem::path& path,
         const double& time,
         const double& n0ForNumberDensity = 1.0,
-        const bool binary                = false
+        const bool binary                = false,
+        const bool compressed            = false
+    );
+
+    /// @brief Append the particles to a time series as a frame in the VTK binary (appended) format.
+    /// @param series series to append to
+    /// @param time current time in the simulation
+    /// @param n0ForNumberDensity reference number density for the number density calculation
+    /// @param compressed if true, the data are compressed by zlib (vtkZLibDataCompressor)
+    /// @return whether the frame has been written
+    bool toVtuSeries(
+        VtuSeries& series, const double& time, const double& n0ForNumberDensity = 1.0, const bool compressed = false
     );
 
     /// @brief Export the particles to a file in the CSV format.
     /// @param path path to the file to write
     /// @param time current time in the simulation
-    void toCsv(const std::filesystem::path& path, const double& time);
+    /// @return whether the file has been written
+    bool toCsv(const std::filesystem::path& path, const double& time);
 };
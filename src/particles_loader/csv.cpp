@@ -1,12 +1,14 @@
 #include "csv.hpp"
 
 #include "../particles.hpp"
+#include "text_parser.hpp"
 
 #include <Eigen/Dense>
-#include <csv.h>
-#include <fstream>
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 using ParticlesLoader::Csv;
 using std::cerr;
@@ -16,26 +18,77 @@ Csv::Csv() {
 }
 
 std::pair<double, Particles> Csv::load(const fs::path& path, double defaultDensity) {
-    io::CSVReader<9> in(path.string());
-    double startTime    = std::stod(in.next_line());
-    double numParticles = std::stod(in.next_line());
-
-    in.read_header(io::ignore_missing_column, "type", "fluidType", "x", "y", "z", "vx", "vy", "vz", "density");
-    int type;
-    int fluidType = 0;
-    double x, y, z, vx, vy, vz;
-    double density = -1.0;
+    auto error = [&path](const std::string& message) {
+        cerr << "Error: " << message << ": " << fs::absolute(path) << endl;
+        std::exit(-1);
+    };
+
+    std::string content;
+    if (!TextParser::readFile(path, content)) {
+        error("cannot read csv file");
+    }
+
+    // the first two lines are the time and the number of particles, and the third line is the header
+    const char* begin = content.data();
+    const char* end   = content.data() + content.size();
+    std::vector<std::string> lines;
+    while (lines.size() < 3 && begin < end) {
+        const char* lineEnd = std::find(begin, end, '\n');
+        std::string line(begin, lineEnd);
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        lines.push_back(line);
+        begin = std::min(lineEnd + 1, end);
+    }
+    if (lines.size() < 3) {
+        error("csv file is truncated");
+    }
+    double startTime = std::stod(lines[0]);
+
+    // column index of each field. Missing columns are filled with the default values.
+    const std::vector<std::string> names = {"type", "fluidType", "x", "y", "z", "vx", "vy", "vz", "density"};
+    const std::vector<double> defaults   = {0, 0, 0, 0, 0, 0, 0, 0, -1.0};
+    std::vector<int> columns(names.size(), -1);
+    int numColumns = 0;
+    for (size_t pos = 0; pos <= lines[2].size(); numColumns++) {
+        size_t comma     = std::min(lines[2].find(',', pos), lines[2].size());
+        std::string name = lines[2].substr(pos, comma - pos);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        auto found = std::find(names.begin(), names.end(), name);
+        if (found != names.end())
+            columns[found - names.begin()] = numColumns;
+        pos = comma + 1;
+    }
+
+    std::vector<double> values;
+    if (!TextParser::parseNumbers(begin, end, values)) {
+        error("csv file contains something other than numbers");
+    }
+    if (values.size() % numColumns != 0) {
+        error("number of values in csv file is not a multiple of the number of columns");
+    }
+
+    size_t numParticles = values.size() / numColumns;
+    if (std::stod(lines[1]) != static_cast<double>(numParticles)) {
+        error("number of particles in csv file is different from the one on the second line");
+    }
     Particles particles;
-    while (in.read_row(type, fluidType, x, y, z, vx, vy, vz, density)) {
-        Eigen::Vector3d pos(x, y, z);
-        Eigen::Vector3d vel(vx, vy, vz);
-        if (density < 0) {
-            density = defaultDensity;
-        }
-        particles.add(Particle(particles.size(), static_cast<ParticleType>(type), pos, vel, density, fluidType));
+    particles.reserve(numParticles);
+    for (size_t i = 0; i < numParticles; i++) {
+        const double* row = values.data() + i * numColumns;
+        // value of the field given by the index in names
+        auto field = [&](size_t f) {
+            return columns[f] < 0 ? defaults[f] : row[columns[f]];
+        };
+        auto type      = static_cast<ParticleType>(static_cast<int>(field(0)));
+        int fluidType  = static_cast<int>(field(1));
+        double density = field(8) < 0 ? defaultDensity : field(8);
+        Eigen::Vector3d pos(field(2), field(3), field(4));
+        Eigen::Vector3d vel(field(5), field(6), field(7));
+        particles.add(Particle(particles.size(), type, pos, vel, density, fluidType));
     }
 
-    return std::make_pair(startTime, particles);
+    return std::make_pair(startTime, std::move(particles));
 }
 
 Csv::~Csv() {
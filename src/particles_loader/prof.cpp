@@ -1,7 +1,11 @@
 #include "prof.hpp"
 
-#include <fstream>
+#include "text_parser.hpp"
+
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 using ParticlesLoader::Prof;
 using std::cerr;
@@ -11,32 +15,39 @@ Prof::Prof() {
 }
 
 std::pair<double, Particles> Prof::load(const fs::path& path, double defaultDensity) {
-    std::ifstream ifs;
-    ifs.open(path);
-    if (ifs.fail()) {
-        cerr << "cannot read prof file: " << fs::absolute(path) << endl;
+    std::vector<double> values;
+    {
+        std::string content;
+        if (!TextParser::readFile(path, content)) {
+            cerr << "cannot read prof file: " << fs::absolute(path) << endl;
+            std::exit(-1);
+        }
+        if (!TextParser::parseNumbers(content.data(), content.data() + content.size(), values)) {
+            cerr << "Error: prof file contains something other than numbers: " << fs::absolute(path) << endl;
+            std::exit(-1);
+        }
+    }
+
+    // time, number of particles and 7 values (type, position and velocity) for each particle
+    constexpr size_t valuesPerParticle = 7;
+    double startTime                   = values.size() > 0 ? values[0] : NAN;
+    size_t particleSize                = (values.size() > 1 && values[1] > 0) ? static_cast<size_t>(values[1]) : 0;
+    if (values.size() < 2 + particleSize * valuesPerParticle) {
+        cerr << "Error: prof file is truncated: " << fs::absolute(path) << endl;
         std::exit(-1);
     }
 
     Particles particles;
-    double startTime = NAN;
-    int particleSize = 0;
-    ifs >> startTime;
-    ifs >> particleSize;
-    for (int i = 0; i < particleSize; i++) {
-        int type_int = 0;
-        ParticleType type;
-        Eigen::Vector3d pos, vel;
-
-        ifs >> type_int;
-        ifs >> pos.x() >> pos.y() >> pos.z();
-        ifs >> vel.x() >> vel.y() >> vel.z();
-
-        type = static_cast<ParticleType>(type_int);
+    particles.reserve(particleSize);
+    for (size_t i = 0; i < particleSize; i++) {
+        const double* v = values.data() + 2 + i * valuesPerParticle;
+        auto type       = static_cast<ParticleType>(static_cast<int>(v[0]));
+        Eigen::Vector3d pos(v[1], v[2], v[3]);
+        Eigen::Vector3d vel(v[4], v[5], v[6]);
         particles.add(Particle(particles.size(), type, pos, vel, defaultDensity));
     }
 
-    return {startTime, particles};
+    return {startTime, std::move(particles)};
 }
 
 Prof::~Prof() {
@@ -0,0 +1,106 @@
+#include "text_parser.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+namespace ParticlesLoader::TextParser {
+
+bool readFile(const fs::path& path, std::string& content) {
+    std::ifstream file(path, std::ios::binary);
+    if (file.fail())
+        return false;
+
+    file.seekg(0, std::ios::end);
+    content.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(content.data(), content.size());
+    return !file.fail();
+}
+
+bool isSeparator(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',';
+}
+
+size_t countNumbers(const char* begin, const char* end) {
+    size_t count      = 0;
+    bool wasSeparator = true;
+    for (const char* p = begin; p < end; p++) {
+        bool separator = isSeparator(*p);
+        if (wasSeparator && !separator)
+            count++;
+        wasSeparator = separator;
+    }
+    return count;
+}
+
+bool parseNumber(const char* begin, const char* end, double& value) {
+#ifdef __cpp_lib_to_chars
+    // std::from_chars does not accept a leading plus sign
+    if (begin < end && *begin == '+')
+        begin++;
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    return ec == std::errc() && ptr == end;
+#else
+    // Some standard libraries, e.g. libc++ of Apple, do not provide std::from_chars for floating-point numbers.
+    // std::strtod needs a null-terminated string, so the token is copied.
+    constexpr size_t bufferSize = 64;
+    size_t length               = static_cast<size_t>(end - begin);
+    if (length == 0 || length >= bufferSize)
+        return false;
+    char buffer[bufferSize];
+    std::memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    char* parsedEnd;
+    value = std::strtod(buffer, &parsedEnd);
+    return parsedEnd == buffer + length;
+#endif
+}
+
+bool parseChunk(const char* begin, const char* end, double* output) {
+    const char* p = begin;
+    while (true) {
+        p = std::find_if_not(p, end, isSeparator);
+        if (p == end)
+            return true;
+        const char* tokenEnd = std::find_if(p, end, isSeparator);
+        if (!parseNumber(p, tokenEnd, *output))
+            return false;
+        output++;
+        p = tokenEnd;
+    }
+}
+
+bool parseNumbers(const char* begin, const char* end, std::vector<double>& values) {
+    // split the text at separators. A chunk boundary never falls in the middle of a number.
+    std::vector<const char*> bounds = {begin};
+    while (static_cast<size_t>(end - bounds.back()) > chunkSize) {
+        const char* p = std::find_if(bounds.back() + chunkSize, end, isSeparator);
+        if (p == end)
+            break;
+        bounds.push_back(p);
+    }
+    bounds.push_back(end);
+    int numChunks = static_cast<int>(bounds.size()) - 1;
+
+    // count the numbers in each chunk to know where to put the numbers of the chunk
+    std::vector<size_t> offsets(numChunks + 1, 0);
+#pragma omp parallel for
+    for (int c = 0; c < numChunks; c++) {
+        offsets[c + 1] = countNumbers(bounds[c], bounds[c + 1]);
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    values.resize(offsets.back());
+    bool isValid = true;
+#pragma omp parallel for reduction(&& : isValid)
+    for (int c = 0; c < numChunks; c++) {
+        isValid = parseChunk(bounds[c], bounds[c + 1], values.data() + offsets[c]) && isValid;
+    }
+    return isValid;
+}
+
+} // namespace ParticlesLoader::TextParser
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Functions for parsing text files of particles
+ *
+ * @details The file is read into memory at once and the numbers in it are parsed by std::from_chars, or by std::strtod
+ * where the standard library does not provide std::from_chars for floating-point numbers. Large text is split into
+ * chunks at separators so that the chunks are parsed in parallel.
+ */
+namespace ParticlesLoader::TextParser {
+
+/// @brief approximate number of characters in a chunk parsed by a thread
+constexpr size_t chunkSize = 1 << 20;
+
+/**
+ * @brief read the whole file into a string
+ * @param path path to the file
+ * @param content content of the file
+ * @return false if the file cannot be read
+ */
+bool readFile(const fs::path& path, std::string& content);
+
+/**
+ * @brief whether the character separates numbers (white space or comma)
+ */
+bool isSeparator(char c);
+
+/**
+ * @brief number of numbers in the text
+ */
+size_t countNumbers(const char* begin, const char* end);
+
+/**
+ * @brief parse a number
+ * @param begin beginning of the number
+ * @param end end of the number
+ * @param value parsed number
+ * @return false if the text is not a number as a whole
+ */
+bool parseNumber(const char* begin, const char* end, double& value);
+
+/**
+ * @brief parse the numbers in the text sequentially
+ * @param begin beginning of the text
+ * @param end end of the text
+ * @param output destination of the numbers, which must have room for all of them
+ * @return false if the text contains something other than numbers and separators
+ */
+bool parseChunk(const char* begin, const char* end, double* output);
+
+/**
+ * @brief parse all the numbers in the text in parallel
+ * @param begin beginning of the text
+ * @param end end of the text
+ * @param values parsed numbers
+ * @return false if the text contains something other than numbers and separators
+ */
+bool parseNumbers(const char* begin, const char* end, std::vector<double>& values);
+
+} // namespace ParticlesLoader::TextParser
@@ -1,10 +1,14 @@
 #include "vtu.hpp"
 
-#include <fstream>
+#include "text_parser.hpp"
+
+#include <array>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
+#include <zlib.h>
 
 using ParticlesLoader::Vtu;
 using std::cerr;
@@ -14,117 +18,280 @@ Vtu::Vtu() {
 }
 
 std::pair<double, Particles> Vtu::load(const fs::path& path, double defaultDensity) {
-    std::ifstream ifs(path);
-    if (ifs.fail()) {
+    auto error = [&path](const std::string& message) {
+        cerr << "Error: " << message << ": " << fs::absolute(path) << endl;
+        std::exit(-1);
+    };
+
+    std::string content;
+    if (!TextParser::readFile(path, content)) {
         cerr << "cannot read vtu file: " << fs::absolute(path) << endl;
         std::exit(-1);
     }
 
-    // Check if the file contains "<AppendedData>" tag
-    std::string line;
-    while (std::getline(ifs, line)) {
-        if (line.find("<AppendedData") != std::string::npos) {
-            cerr << "Error: Binary VTU files are not supported: " << fs::absolute(path) << endl;
-            std::exit(-1);
-        }
+    auto vtkFile        = attributes(content, content.find("<VTKFile"));
+    uint32_t one        = 1;
+    bool isLittleEndian = (*reinterpret_cast<uint8_t*>(&one) == 1);
+    bool isSameOrder    = (vtkFile["byte_order"] == "LittleEndian") == isLittleEndian;
+    // header_type is UInt32 if it is not specified
+    size_t headerSize = (vtkFile["header_type"] == "UInt64") ? sizeof(uint64_t) : sizeof(uint32_t);
+    bool compressed   = vtkFile.count("compressor") > 0;
+    if (compressed && vtkFile["compressor"] != "vtkZLibDataCompressor") {
+        error("compressor " + vtkFile["compressor"] + " is not supported");
     }
 
-    // Reset the file stream to the beginning for further processing
-    ifs.clear();
-    ifs.seekg(0, std::ios::beg);
+    size_t appendedBegin  = content.find("<AppendedData");
+    size_t dataBegin      = std::string::npos;
+    bool isAppendedBase64 = false;
+    if (appendedBegin != std::string::npos) {
+        std::string encoding = attributes(content, appendedBegin)["encoding"];
+        if (encoding != "raw" && encoding != "base64") {
+            error("encoding " + encoding + " of appended data is not supported");
+        }
+        isAppendedBase64 = (encoding == "base64");
+        // appended data start after '_'
+        dataBegin = content.find('_', content.find('>', appendedBegin)) + 1;
+    }
 
-    // Load start
-    double startTime = NAN;
-    Particles particles;
+    // attributes and positions of data arrays by name
+    std::map<std::string, std::map<std::string, std::string>> dataArrays;
+    std::map<std::string, size_t> dataArrayBegins;
+    for (size_t pos = content.find("<DataArray"); pos < appendedBegin; pos = content.find("<DataArray", pos + 1)) {
+        auto dataArray                     = attributes(content, pos);
+        dataArrays[dataArray["Name"]]      = dataArray;
+        dataArrayBegins[dataArray["Name"]] = pos;
+    }
 
-    std::vector<Eigen::Vector3d> positions;
-    std::vector<Eigen::Vector3d> velocities;
-    std::vector<int> types;
-    std::vector<int> fluidTypes;
-    std::vector<double> densities;
-
-    // Parse VTU file
-    while (std::getline(ifs, line)) {
-        // Extract start time
-        if (line.find("Time") != std::string::npos) {
-            std::getline(ifs, line);
-            startTime = std::stod(line);
+    // bytes of the binary data array (decoded and decompressed if needed)
+    auto bytes = [&](const std::string& name) -> std::vector<char> {
+        if (!isSameOrder)
+            error("VTU files of the other byte order are not supported");
+        const auto& dataArray     = dataArrays[name];
+        const std::string& format = dataArray.at("format");
+        bool isBase64             = false;
+        size_t begin              = 0;
+        if (format == "appended") {
+            isBase64 = isAppendedBase64;
+            begin    = dataBegin + std::stoull(dataArray.at("offset"));
+        } else if (format == "binary") {
+            // inline binary data are always encoded in base64
+            isBase64 = true;
+            begin    = content.find_first_not_of(" \t\r\n", content.find('>', dataArrayBegins[name]) + 1);
+        } else {
+            error("format " + format + " of " + name + " is not supported");
         }
 
-        // Extract particle positions
-        if (line.find("Position") != std::string::npos) {
-            while (std::getline(ifs, line) && line.find("</DataArray>") == std::string::npos) {
-                std::istringstream iss(line);
-                double x, y, z;
-                if (!(iss >> x >> y >> z)) {
-                    throw std::runtime_error("Invalid position data format");
-                }
-                positions.emplace_back(x, y, z);
-            }
-        }
+        // length in the file of data of the given bytes. Base64 encodes every 3 bytes into 4 characters.
+        auto encodedLength = [&](size_t size) -> size_t {
+            return isBase64 ? (size + 2) / 3 * 4 : size;
+        };
+
+        // read the given bytes at the position of the file
+        auto read = [&](size_t pos, size_t size) -> std::vector<char> {
+            if (pos > content.size() || encodedLength(size) > content.size() - pos)
+                error("data of " + name + " is truncated");
+            if (!isBase64)
+                return std::vector<char>(content.data() + pos, content.data() + pos + size);
+
+            std::vector<char> decoded;
+            if (!decodeBase64(content.data() + pos, encodedLength(size), decoded) || decoded.size() < size)
+                error("invalid base64 data in " + name);
+            decoded.resize(size);
+            return decoded;
+        };
 
-        // Extract velocities
-        if (line.find("Velocity") != std::string::npos) {
-            while (std::getline(ifs, line) && line.find("</DataArray>") == std::string::npos) {
-                std::istringstream iss(line);
-                double vx, vy, vz;
-                if (!(iss >> vx >> vy >> vz)) {
-                    throw std::runtime_error("Invalid velocity data format");
+        // read header values at the position of the file
+        auto header = [&](size_t pos, size_t count) -> std::vector<uint64_t> {
+            std::vector<char> data = read(pos, count * headerSize);
+            std::vector<uint64_t> values(count);
+            for (size_t i = 0; i < count; i++) {
+                if (headerSize == sizeof(uint64_t)) {
+                    std::memcpy(&values[i], data.data() + i * sizeof(uint64_t), sizeof(uint64_t));
+                } else {
+                    uint32_t value;
+                    std::memcpy(&value, data.data() + i * sizeof(uint32_t), sizeof(uint32_t));
+                    values[i] = value;
                 }
-                velocities.emplace_back(vx, vy, vz);
             }
+            return values;
+        };
+
+        if (!compressed) {
+            size_t size         = header(begin, 1)[0];
+            size_t headerLength = encodedLength(headerSize);
+            // VTK encodes the header and the data separately in base64 so that the header ends with padding, while
+            // some writers encode them together.
+            bool isHeaderPadded = isBase64 && std::memchr(content.data() + begin, '=', headerLength) != nullptr;
+            if (!isBase64 || isHeaderPadded)
+                return read(begin + headerLength, size);
+
+            std::vector<char> data = read(begin, headerSize + size);
+            data.erase(data.begin(), data.begin() + headerSize);
+            return data;
         }
 
-        // Extract particle types
-        if (line.find("Particle Type") != std::string::npos) {
-            while (std::getline(ifs, line) && line.find("</DataArray>") == std::string::npos) {
-                int type;
-                std::istringstream iss(line);
-                if (!(iss >> type)) {
-                    throw std::runtime_error("Invalid particle type data format");
-                }
-                types.push_back(type);
-            }
+        // header of compressed data: number of blocks, block size, last block size and compressed sizes of blocks
+        std::vector<uint64_t> blockHeader = header(begin, 3);
+        size_t numBlocks                  = blockHeader[0];
+        size_t blockSize                  = blockHeader[1];
+        size_t lastBlockSize              = (blockHeader[2] == 0) ? blockSize : blockHeader[2];
+        blockHeader                       = header(begin, 3 + numBlocks);
+        std::vector<size_t> compressedBegin(numBlocks + 1, 0);
+        for (size_t b = 0; b < numBlocks; b++) {
+            compressedBegin[b + 1] = compressedBegin[b] + blockHeader[3 + b];
         }
+        // compressed blocks follow the header. In base64, they are encoded separately from the header.
+        std::vector<char> compressedData =
+            read(begin + encodedLength((3 + numBlocks) * headerSize), compressedBegin[numBlocks]);
 
-        // Extract fluid types
-        if (line.find("Fluid Type") != std::string::npos) {
-            while (std::getline(ifs, line) && line.find("</DataArray>") == std::string::npos) {
-                int fluidType;
-                std::istringstream iss(line);
-                if (!(iss >> fluidType)) {
-                    throw std::runtime_error("Invalid fluid type data format");
-                }
-                fluidTypes.push_back(fluidType);
+        std::vector<char> data(numBlocks == 0 ? 0 : (numBlocks - 1) * blockSize + lastBlockSize);
+        bool failed = false;
+#pragma omp parallel for
+        for (int b = 0; b < static_cast<int>(numBlocks); b++) {
+            uLongf size = (b + 1 == static_cast<int>(numBlocks)) ? lastBlockSize : blockSize;
+            int result  = uncompress(
+                reinterpret_cast<Bytef*>(data.data() + b * blockSize),
+                &size,
+                reinterpret_cast<const Bytef*>(compressedData.data() + compressedBegin[b]),
+                compressedBegin[b + 1] - compressedBegin[b]
+            );
+            if (result != Z_OK) {
+#pragma omp atomic write
+                failed = true;
             }
         }
+        if (failed)
+            error("failed to decompress data of " + name);
+        return data;
+    };
 
-        // Extract densities
-        if (line.find("Density") != std::string::npos) {
-            while (std::getline(ifs, line) && line.find("</DataArray>") == std::string::npos) {
-                double density;
-                std::istringstream iss(line);
-                if (!(iss >> density)) {
-                    throw std::runtime_error("Invalid density data format");
-                }
-                densities.push_back(density);
-            }
+    // values of the data array converted to double
+    auto values = [&](const std::string& name) -> std::vector<double> {
+        if (dataArrays.count(name) == 0)
+            return {};
+        if (dataArrays[name]["format"] == "ascii") {
+            size_t begin = content.find('>', dataArrayBegins[name]) + 1;
+            size_t end   = content.find("</DataArray>", begin);
+            if (end == std::string::npos)
+                error("data of " + name + " is not closed");
+            std::vector<double> values;
+            if (!TextParser::parseNumbers(content.data() + begin, content.data() + end, values))
+                error("invalid ascii data in " + name);
+            return values;
         }
-    }
+        std::vector<char> data  = bytes(name);
+        const std::string& type = dataArrays[name].at("type");
+        if (type == "Float64")
+            return convert<double>(data);
+        if (type == "Float32")
+            return convert<float>(data);
+        if (type == "Int64")
+            return convert<int64_t>(data);
+        if (type == "Int32")
+            return convert<int32_t>(data);
+        if (type == "UInt8")
+            return convert<uint8_t>(data);
+        error("data type " + type + " of " + name + " is not supported");
+        return {};
+    };
+
+    std::vector<double> time       = values("Time");
+    std::vector<double> positions  = values("Position");
+    std::vector<double> velocities = values("Velocity");
+    std::vector<double> types      = values("Particle Type");
+    std::vector<double> fluidTypes = values("Fluid Type");
+    std::vector<double> densities  = values("Density");
+    double startTime               = time.empty() ? NAN : time[0];
 
-    // Construct particles
-    size_t numParticles = positions.size();
+    Particles particles;
+    size_t numParticles = positions.size() / 3;
+    particles.reserve(numParticles);
     for (size_t i = 0; i < numParticles; ++i) {
-        Eigen::Vector3d pos = positions[i];
-        Eigen::Vector3d vel = (i < velocities.size()) ? velocities[i] : Eigen::Vector3d(0, 0, 0);
-        int type            = (i < types.size()) ? types[i] : 0;
-        int fluidType       = (i < fluidTypes.size()) ? fluidTypes[i] : 0;
+        Eigen::Vector3d pos(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+        Eigen::Vector3d vel = (3 * i + 2 < velocities.size())
+                                  ? Eigen::Vector3d(velocities[3 * i], velocities[3 * i + 1], velocities[3 * i + 2])
+                                  : Eigen::Vector3d(0, 0, 0);
+        int type            = (i < types.size()) ? static_cast<int>(types[i]) : 0;
+        int fluidType       = (i < fluidTypes.size()) ? static_cast<int>(fluidTypes[i]) : 0;
         double density      = (i < densities.size() && densities[i] >= 0) ? densities[i] : defaultDensity;
 
         particles.add(Particle(particles.size(), static_cast<ParticleType>(type), pos, vel, density, fluidType));
     }
 
-    return {startTime, particles};
+    return {startTime, std::move(particles)};
+}
+
+std::map<std::string, std::string> Vtu::attributes(const std::string& content, size_t tagBegin) {
+    std::map<std::string, std::string> attributes;
+    size_t tagEnd = content.find('>', tagBegin);
+    size_t pos    = content.find(' ', tagBegin);
+    while (pos < tagEnd) {
+        size_t equal = content.find('=', pos);
+        if (equal >= tagEnd)
+            break;
+        // values are quoted by either double or single quotes
+        size_t quote      = content.find_first_of("\"'", equal);
+        size_t valueBegin = quote + 1;
+        size_t valueEnd   = content.find(content[quote], valueBegin);
+        size_t nameBegin  = content.find_first_not_of(" \t\r\n", pos);
+        std::string name  = content.substr(nameBegin, equal - nameBegin);
+        name.erase(name.find_last_not_of(" \t\r\n") + 1);
+        attributes[name] = content.substr(valueBegin, valueEnd - valueBegin);
+        pos              = valueEnd + 1;
+    }
+    return attributes;
+}
+
+bool Vtu::decodeBase64(const char* text, size_t length, std::vector<char>& bytes) {
+    // value of each character in base64. -1 for invalid characters.
+    static const std::array<int8_t, 256> table = [] {
+        std::array<int8_t, 256> table{};
+        table.fill(-1);
+        const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (size_t i = 0; i < alphabet.size(); i++) {
+            table[static_cast<uint8_t>(alphabet[i])] = static_cast<int8_t>(i);
+        }
+        return table;
+    }();
+
+    if (length % 4 != 0)
+        return false;
+    size_t padding = 0;
+    while (padding < 2 && padding < length && text[length - 1 - padding] == '=') {
+        padding++;
+    }
+
+    int64_t numGroups = static_cast<int64_t>(length / 4);
+    bytes.resize(numGroups * 3);
+    bool isValid = true;
+#pragma omp parallel for reduction(&& : isValid)
+    for (int64_t g = 0; g < numGroups; g++) {
+        uint32_t group = 0;
+        for (size_t k = 0; k < 4; k++) {
+            size_t pos = g * 4 + k;
+            int value  = (pos >= length - padding) ? 0 : table[static_cast<uint8_t>(text[pos])];
+            if (value < 0) {
+                isValid = false;
+                value   = 0;
+            }
+            group = (group << 6) | static_cast<uint32_t>(value);
+        }
+        bytes[g * 3]     = static_cast<char>((group >> 16) & 0xff);
+        bytes[g * 3 + 1] = static_cast<char>((group >> 8) & 0xff);
+        bytes[g * 3 + 2] = static_cast<char>(group & 0xff);
+    }
+    bytes.resize(numGroups * 3 - padding);
+    return isValid;
+}
+
+template <typename T> std::vector<double> Vtu::convert(const std::vector<char>& bytes) {
+    std::vector<double> values(bytes.size() / sizeof(T));
+    for (size_t i = 0; i < values.size(); i++) {
+        T value;
+        std::memcpy(&value, bytes.data() + i * sizeof(T), sizeof(T));
+        values[i] = static_cast<double>(value);
+    }
+    return values;
 }
 
 Vtu::~Vtu() {
@@ -2,6 +2,10 @@
 
 #include "interface.hpp"
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace ParticlesLoader {
 
 /**
@@ -12,6 +16,8 @@ class Vtu : public Interface {
 public:
     /**
      * @brief Load particles from a VTU file
+     * @details Data arrays of ascii format, binary format (base64) and in AppendedData (raw or base64 encoding) are
+     * supported. Binary data can be compressed by vtkZLibDataCompressor.
      * @param path Path to the VTU file
      * @param defaultDensity Default density to use if not specified in the file
      * @return Pair of simulation start time and particles
@@ -20,5 +26,28 @@ public:
 
     ~Vtu() override;
     Vtu();
+
+private:
+    /**
+     * @brief attributes of an XML tag
+     * @param content XML content
+     * @param tagBegin position of '<' of the tag
+     * @return map from attribute names to their values
+     */
+    static std::map<std::string, std::string> attributes(const std::string& content, size_t tagBegin);
+
+    /**
+     * @brief decode base64 text
+     * @param text beginning of the base64 text
+     * @param length number of characters, which must be a multiple of 4
+     * @param bytes decoded bytes
+     * @return false if the text is not valid base64
+     */
+    static bool decodeBase64(const char* text, size_t length, std::vector<char>& bytes);
+
+    /**
+     * @brief convert binary data of type T to double
+     */
+    template <typename T> static std::vector<double> convert(const std::vector<char>& bytes);
 };
 } // namespace ParticlesLoader
@@ -0,0 +1,62 @@
+#include "particles_snapshot.hpp"
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+void ParticlesSnapshot::capture(const Particles& particles, const std::vector<ParticleField>& fields) {
+    auto captures = [&fields](ParticleField field) {
+        return std::find(fields.begin(), fields.end(), field) != fields.end();
+    };
+    // arrays of the fields not captured are emptied, but keep their memory for later captures
+    size_t n = particles.size();
+    position.resize(n);
+    type.resize(captures(ParticleField::Type) ? n : 0);
+    velocity.resize(captures(ParticleField::Velocity) ? n : 0);
+    pressure.resize(captures(ParticleField::Pressure) ? n : 0);
+    numberDensity.resize(captures(ParticleField::NumberDensity) ? n : 0);
+    boundaryCondition.resize(captures(ParticleField::BoundaryCondition) ? n : 0);
+    fluidType.resize(captures(ParticleField::FluidType) ? n : 0);
+    originalId.resize(captures(ParticleField::OriginalId) ? n : 0);
+
+    auto copy = [&](const int i) {
+        const Particle& p = particles[i];
+        position[i]       = p.position;
+        if (!type.empty())
+            type[i] = p.type;
+        if (!velocity.empty())
+            velocity[i] = p.velocity;
+        if (!pressure.empty())
+            pressure[i] = p.pressure;
+        if (!numberDensity.empty())
+            numberDensity[i] = p.numberDensity;
+        if (!boundaryCondition.empty())
+            boundaryCondition[i] = p.boundaryCondition;
+        if (!fluidType.empty())
+            fluidType[i] = p.fluidType;
+        if (!originalId.empty())
+            originalId[i] = p.originalId;
+    };
+
+#ifdef _OPENMP
+    // in a task of TaskGraph, the copy shares the threads of the round with the other tasks
+    if (omp_in_parallel()) {
+#pragma omp taskloop shared(copy)
+        for (int i = 0; i < static_cast<int>(n); i++) {
+            copy(i);
+        }
+        return;
+    }
+#endif
+
+#pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(n); i++) {
+        copy(i);
+    }
+}
+
+size_t ParticlesSnapshot::size() const {
+    return position.size();
+}
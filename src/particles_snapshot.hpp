@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common.hpp"
+#include "particle_field.hpp"
+#include "particles.hpp"
+
+#include <Eigen/Dense>
+#include <vector>
+
+/**
+ * @brief Copy of the particle fields that are exported to files
+ *
+ * @details Unlike Particles, it does not contain the neighbor lists and the fields used only in the calculation. Only
+ * the position and the requested fields are copied, and the others are left empty. The fields are stored as arrays
+ * (structure of arrays), and capturing particles again into the same snapshot reuses the memory of the arrays, so that
+ * taking a snapshot at every output does not allocate memory once the number of particles has settled.
+ */
+class ParticlesSnapshot {
+public:
+    std::vector<Eigen::Vector3d> position;     ///< position of the particles
+    std::vector<ParticleType> type;            ///< type of the particles
+    std::vector<Eigen::Vector3d> velocity;     ///< velocity of the particles
+    std::vector<double> pressure;              ///< pressure of the particles
+    std::vector<double> numberDensity;         ///< number density of the particles
+    std::vector<FluidState> boundaryCondition; ///< boundary condition of the particles
+    std::vector<int> fluidType;                ///< type of the fluid
+    std::vector<int> originalId;               ///< id of the particles when they were loaded
+
+    /**
+     * @brief copy the position and the given fields of the particles
+     * @details When it is called in a parallel region, e.g. in a task of TaskGraph, the particles are copied in tasks
+     * taken by the threads of the region, since a nested parallel region would run on a single thread.
+     * @param particles particles to copy
+     * @param fields fields to copy in addition to the position
+     */
+    void capture(const Particles& particles, const std::vector<ParticleField>& fields = allParticleFields());
+
+    /**
+     * @brief Get the number of particles
+     *
+     * @return size_t the number of particles
+     */
+    size_t size() const;
+};
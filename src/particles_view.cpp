@@ -0,0 +1,51 @@
+#include "particles_view.hpp"
+
+ParticlesView::ParticlesView(const Particles& particles) {
+    numParticles = particles.size();
+    if (numParticles == 0)
+        return;
+
+    // Particles stores the particles contiguously, so each field is placed every sizeof(Particle) bytes.
+    const Particle& first = particles[0];
+    constexpr size_t s    = sizeof(Particle);
+    positions             = {&first.position, s};
+    types                 = {&first.type, s};
+    velocities            = {&first.velocity, s};
+    pressures             = {&first.pressure, s};
+    numberDensities       = {&first.numberDensity, s};
+    boundaryConditions    = {&first.boundaryCondition, s};
+    fluidTypes            = {&first.fluidType, s};
+    originalIds           = {&first.originalId, s};
+}
+
+ParticlesView::ParticlesView(const ParticlesSnapshot& snapshot) {
+    numParticles       = snapshot.size();
+    positions          = viewOf(snapshot.position, numParticles);
+    types              = viewOf(snapshot.type, numParticles);
+    velocities         = viewOf(snapshot.velocity, numParticles);
+    pressures          = viewOf(snapshot.pressure, numParticles);
+    numberDensities    = viewOf(snapshot.numberDensity, numParticles);
+    boundaryConditions = viewOf(snapshot.boundaryCondition, numParticles);
+    fluidTypes         = viewOf(snapshot.fluidType, numParticles);
+    originalIds        = viewOf(snapshot.originalId, numParticles);
+}
+
+bool ParticlesView::has(const ParticleField& field) const {
+    switch (field) {
+    case ParticleField::Type:
+        return !types.empty();
+    case ParticleField::Velocity:
+        return !velocities.empty();
+    case ParticleField::Pressure:
+        return !pressures.empty();
+    case ParticleField::NumberDensity:
+        return !numberDensities.empty();
+    case ParticleField::BoundaryCondition:
+        return !boundaryConditions.empty();
+    case ParticleField::FluidType:
+        return !fluidTypes.empty();
+    case ParticleField::OriginalId:
+        return !originalIds.empty();
+    }
+    return false;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "common.hpp"
+#include "particle_field.hpp"
+#include "particles.hpp"
+#include "particles_snapshot.hpp"
+
+#include <Eigen/Dense>
+#include <cstddef>
+
+/**
+ * @brief Read-only view of the exported fields of particles
+ *
+ * @details Each field is accessed through a pointer to its first element and the distance in bytes between the
+ * elements (stride). A view of Particles points into its particles, and a view of ParticlesSnapshot points into its
+ * arrays, so creating a view copies nothing. The viewed particles must not be changed or destroyed while the view is
+ * used.
+ */
+class ParticlesView {
+public:
+    ParticlesView() = default;
+
+    /**
+     * @brief view of all the fields of the particles
+     */
+    explicit ParticlesView(const Particles& particles);
+
+    /**
+     * @brief view of the fields captured in the snapshot
+     */
+    explicit ParticlesView(const ParticlesSnapshot& snapshot);
+
+    /**
+     * @brief Get the number of particles
+     */
+    size_t size() const {
+        return numParticles;
+    }
+
+    /**
+     * @brief whether the field can be accessed through this view
+     */
+    bool has(const ParticleField& field) const;
+
+    const Eigen::Vector3d& position(size_t i) const {
+        return positions[i];
+    }
+    const ParticleType& type(size_t i) const {
+        return types[i];
+    }
+    const Eigen::Vector3d& velocity(size_t i) const {
+        return velocities[i];
+    }
+    const double& pressure(size_t i) const {
+        return pressures[i];
+    }
+    const double& numberDensity(size_t i) const {
+        return numberDensities[i];
+    }
+    const FluidState& boundaryCondition(size_t i) const {
+        return boundaryConditions[i];
+    }
+    const int& fluidType(size_t i) const {
+        return fluidTypes[i];
+    }
+    const int& originalId(size_t i) const {
+        return originalIds[i];
+    }
+
+private:
+    /**
+     * @brief elements placed at a constant distance in memory
+     */
+    template <typename T> class StridedField {
+    public:
+        StridedField() = default;
+
+        StridedField(const T* first, size_t stride) {
+            this->first  = reinterpret_cast<const std::byte*>(first);
+            this->stride = stride;
+        }
+
+        const T& operator[](size_t i) const {
+            return *reinterpret_cast<const T*>(first + i * stride);
+        }
+
+        bool empty() const {
+            return first == nullptr;
+        }
+
+    private:
+        const std::byte* first = nullptr;
+        size_t stride          = 0;
+    };
+
+    size_t numParticles = 0;
+    StridedField<Eigen::Vector3d> positions;
+    StridedField<ParticleType> types;
+    StridedField<Eigen::Vector3d> velocities;
+    StridedField<double> pressures;
+    StridedField<double> numberDensities;
+    StridedField<FluidState> boundaryConditions;
+    StridedField<int> fluidTypes;
+    StridedField<int> originalIds;
+
+    /// @brief view of a vector of the snapshot, or an empty field if the vector was not captured
+    template <typename T> static StridedField<T> viewOf(const std::vector<T>& values, size_t numParticles) {
+        if (numParticles == 0 || values.size() != numParticles)
+            return {};
+        return {values.data(), sizeof(T)};
+    }
+};
@@ -0,0 +1,235 @@
+#include "performance_report.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace fs = std::filesystem;
+
+void PerformanceReport::addStep(const double seconds, const int numParticles, const int solverIterations) {
+    stepSecondsList.push_back(seconds);
+    solverIterationsList.push_back(solverIterations);
+    particleUpdates += numParticles;
+}
+
+void PerformanceReport::setWallSeconds(const double seconds) {
+    this->wallSeconds = seconds;
+}
+
+void PerformanceReport::setStageSeconds(const std::map<StepStage, double>& stageSeconds) {
+    this->stageSeconds = stageSeconds;
+}
+
+void PerformanceReport::setOutputTime(const OutputTime& output, const OutputTime& checkpoint) {
+    this->outputTime     = output;
+    this->checkpointTime = checkpoint;
+}
+
+void PerformanceReport::setOutputBytes(const uintmax_t bytes) {
+    this->outputBytes = bytes;
+}
+
+int PerformanceReport::numSteps() const {
+    return static_cast<int>(stepSecondsList.size());
+}
+
+double PerformanceReport::particleUpdatesPerSecond() const {
+    double seconds = stepSeconds().total;
+    return seconds > 0.0 ? particleUpdates / seconds : 0.0;
+}
+
+PerformanceReport::Statistics PerformanceReport::stepSeconds() const {
+    return calcStatistics(stepSecondsList);
+}
+
+PerformanceReport::Statistics PerformanceReport::solverIterations() const {
+    return calcStatistics(solverIterationsList);
+}
+
+double PerformanceReport::otherStageSeconds() const {
+    double seconds = stepSeconds().total;
+    for (const auto& [stage, stageSecond] : stageSeconds) {
+        seconds -= stageSecond;
+    }
+    return std::max(seconds, 0.0);
+}
+
+std::vector<std::pair<std::string, double>> PerformanceReport::stageSecondsPerStep() const {
+    int steps = std::max(numSteps(), 1);
+    std::vector<std::pair<std::string, double>> perStep;
+    for (const auto& [stage, seconds] : stageSeconds) {
+        perStep.emplace_back(stepStageName(stage), seconds / steps);
+    }
+    perStep.emplace_back("Other", otherStageSeconds() / steps);
+    return perStep;
+}
+
+std::string PerformanceReport::toJson() const {
+    std::stringstream json;
+    json << std::setprecision(9);
+    auto writeStatistics = [&](const Statistics& s) {
+        json << "{\"total\": " << s.total << ", \"mean\": " << s.mean << ", \"min\": " << s.min
+             << ", \"p50\": " << s.p50 << ", \"p90\": " << s.p90 << ", \"p99\": " << s.p99 << ", \"max\": " << s.max
+             << "}";
+    };
+    auto writeOutputTime = [&](const OutputTime& t) {
+        json << "{\"waitSeconds\": " << t.waitSeconds << ", \"writeSeconds\": " << t.writeSeconds << "}";
+    };
+
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    int64_t peakResident = peakResidentBytes();
+
+    json << "{\n";
+    json << "  \"threads\": " << threads << ",\n";
+    json << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+    json << "  \"steps\": " << numSteps() << ",\n";
+    json << "  \"wallSeconds\": " << wallSeconds << ",\n";
+    json << "  \"particleUpdates\": " << particleUpdates << ",\n";
+    json << "  \"particleUpdatesPerSecond\": " << particleUpdatesPerSecond() << ",\n";
+    json << "  \"stepSeconds\": ";
+    writeStatistics(stepSeconds());
+    json << ",\n";
+    json << "  \"solverIterations\": ";
+    writeStatistics(solverIterations());
+    json << ",\n";
+    // seconds per step of each stage, so that runs of different lengths can be compared
+    json << "  \"stageSecondsPerStep\": {";
+    auto perStep = stageSecondsPerStep();
+    for (size_t i = 0; i < perStep.size(); i++) {
+        json << (i == 0 ? "" : ", ") << "\"" << perStep[i].first << "\": " << perStep[i].second;
+    }
+    json << "},\n";
+    json << "  \"output\": ";
+    writeOutputTime(outputTime);
+    json << ",\n";
+    json << "  \"checkpoint\": ";
+    writeOutputTime(checkpointTime);
+    json << ",\n";
+    json << "  \"outputBytes\": " << outputBytes << ",\n";
+    if (peakResident < 0) {
+        json << "  \"peakResidentBytes\": null\n";
+    } else {
+        json << "  \"peakResidentBytes\": " << peakResident << "\n";
+    }
+    json << "}\n";
+    return json.str();
+}
+
+std::string PerformanceReport::toTable() const {
+    std::stringstream table;
+    auto line = [&](const std::string& name) -> std::stringstream& {
+        table << std::left << std::setw(28) << name << std::right << ": ";
+        return table;
+    };
+
+    Statistics step       = stepSeconds();
+    Statistics iterations = solverIterations();
+    int64_t peakResident  = peakResidentBytes();
+
+    table << std::fixed;
+    line("time steps") << numSteps() << "\n";
+    line("wall-clock time") << std::setprecision(3) << wallSeconds << " s\n";
+    line("particle updates per second") << std::scientific << std::setprecision(3) << particleUpdatesPerSecond()
+                                        << std::fixed << "\n";
+    line("step time [ms]") << std::setprecision(3) << "mean " << step.mean * 1e3 << "   p50 " << step.p50 * 1e3
+                           << "   p90 " << step.p90 * 1e3 << "   p99 " << step.p99 * 1e3 << "   max "
+                           << step.max * 1e3 << "\n";
+    line("solver iterations") << std::setprecision(1) << "mean " << iterations.mean << "   p50 " << iterations.p50
+                              << "   p90 " << iterations.p90 << "   p99 " << iterations.p99 << "   max "
+                              << iterations.max << "\n";
+
+    table << "\n" << std::left << std::setw(36) << "stage" << std::right << std::setw(12) << "total [s]"
+          << std::setw(16) << "per step [ms]" << std::setw(10) << "share" << "\n";
+    double total   = std::max(step.total, 1e-300);
+    int steps      = std::max(numSteps(), 1);
+    auto stageLine = [&](const std::string& name, double seconds) {
+        table << std::left << std::setw(36) << name << std::right << std::setprecision(3) << std::setw(12) << seconds
+              << std::setw(16) << seconds / steps * 1e3 << std::setprecision(1) << std::setw(9)
+              << seconds / total * 100.0 << "%\n";
+    };
+    for (const auto& [stage, seconds] : stageSeconds) {
+        stageLine(stepStageName(stage), seconds);
+    }
+    stageLine("Other", otherStageSeconds());
+
+    table << "\n" << std::setprecision(3);
+    line("output") << outputTime.waitSeconds << " s waiting   " << outputTime.writeSeconds << " s writing\n";
+    line("checkpoint") << checkpointTime.waitSeconds << " s waiting   " << checkpointTime.writeSeconds
+                       << " s writing\n";
+    line("output directory") << std::setprecision(1) << outputBytes / double(1 << 20) << " MiB\n";
+    if (peakResident < 0) {
+        line("peak memory") << "-\n";
+    } else {
+        line("peak memory") << std::setprecision(1) << peakResident / double(1 << 20) << " MiB\n";
+    }
+    return table.str();
+}
+
+bool PerformanceReport::write(const fs::path& directory) const {
+    std::ofstream json(directory / "performance.json");
+    json << toJson();
+    std::ofstream table(directory / "performance.txt");
+    table << toTable();
+    json.close();
+    table.close();
+    return !json.fail() && !table.fail();
+}
+
+PerformanceReport::Statistics PerformanceReport::calcStatistics(std::vector<double> values) {
+    Statistics s;
+    if (values.empty())
+        return s;
+
+    std::sort(values.begin(), values.end());
+    // nearest-rank method: the smallest value such that p% of the values are less than or equal to it
+    auto percentile = [&](double p) {
+        auto rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+        return values[std::max(rank, size_t(1)) - 1];
+    };
+    for (const auto& value : values) {
+        s.total += value;
+    }
+    s.mean = s.total / values.size();
+    s.min  = values.front();
+    s.p50  = percentile(50.0);
+    s.p90  = percentile(90.0);
+    s.p99  = percentile(99.0);
+    s.max  = values.back();
+    return s;
+}
+
+int64_t PerformanceReport::peakResidentBytes() {
+    // "VmHWM" in /proc/self/status is the peak resident set size on Linux
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            std::stringstream ss(line.substr(6));
+            int64_t kiloBytes{};
+            ss >> kiloBytes;
+            return kiloBytes * 1024;
+        }
+    }
+    return -1;
+}
+
+uintmax_t PerformanceReport::directoryBytes(const fs::path& directory) {
+    uintmax_t bytes = 0;
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file(error)) {
+            bytes += it->file_size(error);
+        }
+    }
+    return bytes;
+}
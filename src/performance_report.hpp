@@ -0,0 +1,142 @@
+#pragma once
+
+#include "common.hpp"
+#include "step_stage.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Performance statistics of a simulation run
+ *
+ * @details The wall-clock time, the number of particles and the solver iterations of each time step are added by
+ * addStep() during the run, so that the percentiles of them are calculated at the end. The time of each stage and the
+ * time of the output are set at the end of the run. The report is written as JSON to be tracked across versions, and as
+ * a table to be read by humans.
+ */
+class PerformanceReport {
+public:
+    /// @brief statistics of the values of all the time steps
+    struct Statistics {
+        double total{}; ///< sum of the values
+        double mean{};  ///< mean of the values
+        double min{};   ///< minimum of the values
+        double p50{};   ///< median of the values
+        double p90{};   ///< 90th percentile of the values
+        double p99{};   ///< 99th percentile of the values
+        double max{};   ///< maximum of the values
+    };
+
+    /// @brief time spent in writing a kind of output files
+    struct OutputTime {
+        double waitSeconds{};  ///< wall-clock seconds the time steps were stopped for the output
+        double writeSeconds{}; ///< wall-clock seconds spent in writing, in the background thread if asynchronous
+    };
+
+    /**
+     * @brief add a time step
+     * @param seconds wall-clock seconds of the time step
+     * @param numParticles number of particles updated in the time step
+     * @param solverIterations number of iterations of the pressure solver in the time step
+     */
+    void addStep(const double seconds, const int numParticles, const int solverIterations);
+
+    /**
+     * @brief set the wall-clock seconds of the whole run, including the output
+     */
+    void setWallSeconds(const double seconds);
+
+    /**
+     * @brief set the wall-clock seconds spent in each stage of the time steps
+     */
+    void setStageSeconds(const std::map<StepStage, double>& stageSeconds);
+
+    /**
+     * @brief set the time spent in writing output files and checkpoints
+     */
+    void setOutputTime(const OutputTime& output, const OutputTime& checkpoint);
+
+    /**
+     * @brief set the total size of the files in the output directory
+     */
+    void setOutputBytes(const uintmax_t bytes);
+
+    /**
+     * @brief number of time steps added
+     */
+    int numSteps() const;
+
+    /**
+     * @brief number of particles updated per wall-clock second of the time steps
+     */
+    double particleUpdatesPerSecond() const;
+
+    /**
+     * @brief statistics of the wall-clock seconds of the time steps
+     */
+    Statistics stepSeconds() const;
+
+    /**
+     * @brief statistics of the iterations of the pressure solver
+     */
+    Statistics solverIterations() const;
+
+    /**
+     * @brief wall-clock seconds per time step of each stage in the order of the stages, followed by "Other" for the
+     * rest of the time steps
+     */
+    std::vector<std::pair<std::string, double>> stageSecondsPerStep() const;
+
+    /**
+     * @brief report in JSON
+     */
+    std::string toJson() const;
+
+    /**
+     * @brief report in a human-readable table
+     */
+    std::string toTable() const;
+
+    /**
+     * @brief write the report to performance.json and performance.txt in the directory
+     * @return false if any of the files cannot be written
+     */
+    bool write(const std::filesystem::path& directory) const;
+
+    /**
+     * @brief calculate the statistics of the values
+     * @details The percentiles are calculated by the nearest-rank method. All the statistics are 0 if there is no
+     * value.
+     */
+    static Statistics calcStatistics(std::vector<double> values);
+
+    /**
+     * @brief peak resident set size of this process in bytes
+     * @return -1 if it is not available on this system
+     */
+    static int64_t peakResidentBytes();
+
+    /**
+     * @brief total size of the regular files in the directory and its subdirectories in bytes
+     */
+    static uintmax_t directoryBytes(const std::filesystem::path& directory);
+
+private:
+    std::vector<double> stepSecondsList;      ///< wall-clock seconds of each time step
+    std::vector<double> solverIterationsList; ///< iterations of the pressure solver in each time step
+    double particleUpdates{};                 ///< sum of the number of particles over the time steps
+    double wallSeconds{};                     ///< wall-clock seconds of the whole run
+    std::map<StepStage, double> stageSeconds; ///< wall-clock seconds spent in each stage
+    OutputTime outputTime;                    ///< time spent in writing output files
+    OutputTime checkpointTime;                ///< time spent in writing checkpoints
+    uintmax_t outputBytes{};                  ///< total size of the files in the output directory
+
+    /**
+     * @brief seconds of the time steps not spent in any stage, e.g. removing ghost particles
+     */
+    double otherStageSeconds() const;
+};
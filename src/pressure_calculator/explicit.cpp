@@ -4,14 +4,54 @@
 
 using PressureCalculator::Explicit;
 
-Explicit::Explicit(double re, double soundSpeed, int dimension, double particleDistance) {
+Explicit::Explicit(double re, double soundSpeed, int dimension, double particleDistance, bool fuseStages) {
     this->soundSpeed = soundSpeed;
+    this->fuseStages = fuseStages;
     this->n0         = RefValues(dimension, particleDistance, re).n0;
 }
 
 Explicit::~Explicit() {
 }
 
+int Explicit::solverIterations() const {
+    // pressure is calculated from the number density without any linear solve
+    return 0;
+}
+
+std::vector<StepStage> Explicit::stepStages() const {
+    if (fuseStages) {
+        return {
+            StepStage::UpdateNeighbors,
+            StepStage::FusedPrediction,
+            StepStage::FusedCollision,
+            StepStage::UpdateNumberDensity,
+            StepStage::Pressure,
+            StepStage::FusedCorrection,
+            StepStage::Courant,
+        };
+    }
+
+    return {
+        StepStage::SearchNeighbors,
+        StepStage::Gravity,
+        StepStage::Viscosity,
+        StepStage::MoveParticle,
+        StepStage::SearchNeighbors,
+        StepStage::Collision,
+        StepStage::SearchNeighbors,
+        StepStage::NumberDensity,
+        StepStage::Pressure,
+        StepStage::MinimumPressure,
+        StepStage::PressureGradient,
+        StepStage::MoveParticleUsingPressureGradient,
+        // Pressure after the correction step is evaluated from the updated number density. The neighbor list is reused
+        // and only the distances are updated, because the particles move less than a particle distance in a step.
+        StepStage::UpdateNumberDensity,
+        StepStage::Pressure,
+        StepStage::Courant,
+    };
+}
+
 std::vector<double> Explicit::calc(Particles& particles) {
     std::vector<double> pressure;
     pressure.resize(particles.size());
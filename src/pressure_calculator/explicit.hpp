@@ -18,13 +18,27 @@ public:
      * @param particles particles
      */
     std::vector<double> calc(Particles& particles) override;
+    /**
+     * @brief stages of a time step for the explicit scheme
+     * @details When #fuseStages is true, neighbors are searched at most once at the beginning of the step (and only
+     * every few steps when substepping is enabled, see NeighborSearcher::updateNeighbors()) and the stages
+     * are fused into four passes over the neighbors (prediction, collision, number density and correction) without
+     * any linear solve. Pressure is not evaluated again after the correction step in this case, so the exported
+     * pressure is the one used for the pressure gradient.
+     */
+    std::vector<StepStage> stepStages() const override;
+    int solverIterations() const override;
     ~Explicit() override;
 
-    Explicit(double n0, double soundSpeed, int dimension, double particleDistance);
+    /**
+     * @param fuseStages if true, the time step uses the fused stages (see stepStages())
+     */
+    Explicit(double n0, double soundSpeed, int dimension, double particleDistance, bool fuseStages = false);
 
 private:
     double n0;
     double soundSpeed;
+    bool fuseStages; ///< Whether to use the fused stages for the time step
 };
 
 } // namespace PressureCalculator
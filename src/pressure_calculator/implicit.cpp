@@ -48,6 +48,32 @@ std::vector<double> Implicit::calc(Particles& particles) {
 Implicit::~Implicit() {
 }
 
+std::vector<StepStage> Implicit::stepStages() const {
+    return stages();
+}
+
+std::vector<StepStage> Implicit::stages() {
+    return {
+        StepStage::SearchNeighbors,
+        StepStage::Gravity,
+        StepStage::Viscosity,
+        StepStage::MoveParticle,
+        StepStage::SearchNeighbors,
+        StepStage::Collision,
+        StepStage::SearchNeighbors,
+        StepStage::NumberDensity,
+        StepStage::Pressure,
+        StepStage::MinimumPressure,
+        StepStage::PressureGradient,
+        StepStage::MoveParticleUsingPressureGradient,
+        StepStage::Courant,
+    };
+}
+
+int Implicit::solverIterations() const {
+    return pressurePoissonEquation.getIterations();
+}
+
 void Implicit::removeNegativePressure() {
 #pragma omp parallel for
     for (auto& p : pressure) {
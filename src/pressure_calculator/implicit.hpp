@@ -25,8 +25,15 @@ public:
      * @param particles particles
      */
     std::vector<double> calc(Particles& particles) override;
+    std::vector<StepStage> stepStages() const override;
+    int solverIterations() const override;
     ~Implicit() override;
 
+    /**
+     * @brief stages of a time step of the implicit scheme, which are shared with the distributed mode
+     */
+    static std::vector<StepStage> stages();
+
     Implicit(
         int dimension,
         double particleDistance,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../particles.hpp"
+#include "../step_stage.hpp"
 
 #include <vector>
 
@@ -22,6 +23,20 @@ public:
      */
     virtual std::vector<double> calc(Particles& particles) = 0;
 
+    /**
+     * @brief stages of a time step required by this pressure calculation scheme
+     *
+     * @return stages executed in order by MPS::stepForward()
+     */
+    virtual std::vector<StepStage> stepStages() const = 0;
+
+    /**
+     * @brief number of iterations of the linear solver in the last calc()
+     *
+     * @return 0 if the scheme does not solve a linear system
+     */
+    virtual int solverIterations() const = 0;
+
     /**
      * @brief destructor
      */
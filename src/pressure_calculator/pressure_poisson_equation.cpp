@@ -46,6 +46,7 @@ std::vector<double> PressurePoissonEquation::solve() {
     Eigen::BiCGSTAB<Eigen::SparseMatrix<double, Eigen::RowMajor>> solver;
     solver.compute(coefficientMatrix);
     Eigen::VectorXd pressure = solver.solve(sourceTerm);
+    iterations               = static_cast<int>(solver.iterations());
     if (solver.info() != Eigen::Success) {
         cerr << "Pressure calculation failed." << endl;
         std::exit(-1);
@@ -58,6 +59,18 @@ std::vector<double> PressurePoissonEquation::solve() {
     return pressureStdVec;
 }
 
+int PressurePoissonEquation::getIterations() const {
+    return iterations;
+}
+
+const Eigen::SparseMatrix<double, Eigen::RowMajor>& PressurePoissonEquation::getCoefficientMatrix() const {
+    return coefficientMatrix;
+}
+
+const Eigen::VectorXd& PressurePoissonEquation::getSourceTerm() const {
+    return sourceTerm;
+}
+
 void PressurePoissonEquation::resetEquation() {
     coefficientMatrix.resize(particlesCount, particlesCount);
     sourceTerm.resize(particlesCount);
@@ -41,6 +41,21 @@ public:
      */
     std::vector<double> solve();
 
+    /**
+     * @brief number of iterations of the linear solver in the last solve()
+     */
+    int getIterations() const;
+
+    /**
+     * @brief coefficient matrix set up by setup(), whose rows and columns are the ids of the particles
+     */
+    const Eigen::SparseMatrix<double, Eigen::RowMajor>& getCoefficientMatrix() const;
+
+    /**
+     * @brief source term set up by setup(), whose elements are the ids of the particles
+     */
+    const Eigen::VectorXd& getSourceTerm() const;
+
 private:
     int dimension;
     double dt;
@@ -52,6 +67,7 @@ private:
     double reForLaplacian;
     double reForNumberDensity;
     size_t particlesCount;
+    int iterations{}; ///< Number of iterations of the linear solver in the last solve()
 
     std::vector<Eigen::Triplet<double>> matrixTriplets; ///< Triplets for coefficient matrix
     Eigen::SparseMatrix<double, Eigen::RowMajor>
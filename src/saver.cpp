@@ -1,36 +1,90 @@
 #include "saver.hpp"
 
+#include <algorithm>
+
 namespace fs = std::filesystem;
 
-Saver::Saver(const fs::path& dir, const bool outputVtkInBinary) {
-    this->dir               = dir;
-    this->outputVtkInBinary = outputVtkInBinary;
-    fs::create_directories(dir / "prof");
-    fs::create_directories(dir / "vtu");
-    fs::create_directories(dir / "csv");
+Saver::Saver(const fs::path& dir, const Settings& settings) {
+    this->dir                 = dir;
+    this->outputVtkInBinary   = settings.outputVtkInBinary;
+    this->outputVtkCompressed = settings.outputVtkCompressed;
+    this->outputVtkCells      = settings.outputVtkCells;
+    this->formats             = settings.outputFormats;
+    this->fields              = settings.outputFields;
+
+    // Only the fields written in any of the formats are copied for the background thread. Prof and CSV formats always
+    // need the type and the velocity, and CSV format also needs the fluid type.
+    std::vector<ParticleField> capturedFields = fields;
+    if (writes("prof") || writes("csv")) {
+        capturedFields.push_back(ParticleField::Type);
+        capturedFields.push_back(ParticleField::Velocity);
+    }
+    if (writes("csv")) {
+        capturedFields.push_back(ParticleField::FluidType);
+    }
+    this->writer = std::make_unique<OutputWriter>(settings.asyncOutput, capturedFields);
+
+    for (const auto& format : formats) {
+        fs::create_directories(dir / format);
+    }
 };
 
-void Saver::save(const MPS& mps, const double time) {
-    exporter.setParticles(mps.particles);
+bool Saver::writes(const std::string& format) const {
+    return std::find(formats.begin(), formats.end(), format) != formats.end();
+}
 
-    std::stringstream profName;
-    profName << "output_" << std::setfill('0') << std::setw(4) << fileNumber << ".prof";
-    fs::path profPath = dir / "prof" / profName.str();
-    exporter.toProf(profPath, time);
+void Saver::save(const MPS& mps, const double time) {
+    std::stringstream fileName;
+    fileName << "output_" << std::setfill('0') << std::setw(4) << fileNumber;
+    fs::path profPath = dir / "prof" / (fileName.str() + ".prof");
+    fs::path vtuPath  = dir / "vtu" / (fileName.str() + ".vtu");
+    fs::path csvPath  = dir / "csv" / (fileName.str() + ".csv");
 
-    std::stringstream vtuName;
-    vtuName << "output_" << std::setfill('0') << std::setw(4) << fileNumber << ".vtu";
-    fs::path vtuPath = dir / "vtu" / vtuName.str();
-    exporter.toVtu(vtuPath, time, mps.refValuesForNumberDensity.n0, outputVtkInBinary);
+    // The series is opened here since the number of frames to keep is known after setFileNumber() when restarting.
+    // The tasks are run in order, so the frames are appended in order.
+    if (writes("series") && series == nullptr) {
+        series = std::make_shared<VtuSeries>(dir / "series" / "output.vtus", fileNumber);
+    }
 
-    std::stringstream csvName;
-    csvName << "output_" << std::setfill('0') << std::setw(4) << fileNumber << ".csv";
-    fs::path csvPath = dir / "csv" / csvName.str();
-    exporter.toCsv(csvPath, time);
+    double n0      = mps.refValuesForNumberDensity.n0;
+    bool binary    = outputVtkInBinary;
+    bool compress  = outputVtkCompressed;
+    bool cells     = outputVtkCells;
+    bool prof      = writes("prof");
+    bool vtu       = writes("vtu");
+    bool csv       = writes("csv");
+    auto vtuFields = fields;
+    auto vtuSeries = series;
+    writer->write(mps.particles, [=](ParticlesExporter& exporter) {
+        exporter.setFields(vtuFields);
+        exporter.setWritesCells(cells);
+        bool written = true;
+        if (prof)
+            written = exporter.toProf(profPath, time) && written;
+        if (vtu)
+            written = exporter.toVtu(vtuPath, time, n0, binary, compress) && written;
+        if (csv)
+            written = exporter.toCsv(csvPath, time) && written;
+        if (vtuSeries)
+            written = exporter.toVtuSeries(*vtuSeries, time, n0, compress) && written;
+        return written;
+    });
 
     fileNumber++;
 }
 
+void Saver::finish() {
+    writer->finish();
+}
+
+double Saver::getWriteSeconds() const {
+    return writer->getTaskSeconds();
+}
+
 int Saver::getFileNumber() const {
     return fileNumber;
 }
+
+void Saver::setFileNumber(int fileNumber) {
+    this->fileNumber = fileNumber;
+}
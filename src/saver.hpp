@@ -2,31 +2,64 @@
 
 #include "common.hpp"
 #include "mps.hpp"
-#include "particles_exporter.hpp"
+#include "output_writer.hpp"
+#include "vtu_series.hpp"
 
 #include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
 
 /**
  * Saver class
  *
  * This class is responsible for saving the simulation results. It saves the
  * results to the file system. It uses the ParticlesExporter class to export the
- * particles to a file.
+ * particles to a file. The files are written by OutputWriter, in a background
+ * thread when asynchronous output is enabled.
  *
  */
 class Saver {
 private:
-    ParticlesExporter exporter;
+    std::unique_ptr<OutputWriter> writer;
+    std::shared_ptr<VtuSeries> series; ///< series of the "series" format, opened at the first save
     int fileNumber = 0;
     std::filesystem::path dir;
-    bool outputVtkInBinary = false;
+    bool outputVtkInBinary            = false;
+    bool outputVtkCompressed          = false;
+    bool outputVtkCells               = true;
+    std::vector<std::string> formats  = {"prof", "vtu", "csv"}; ///< formats of the files to write
+    std::vector<ParticleField> fields = allParticleFields();    ///< fields written in the VTK format
+
+    bool writes(const std::string& format) const;
 
 public:
     Saver() = default;
 
-    Saver(const std::filesystem::path& dir, const bool binaryFormat);
+    /**
+     * @param dir output directory
+     * @param settings settings of the simulation. The output formats, fields and whether the files are written in a
+     * background thread are taken from it.
+     */
+    Saver(const std::filesystem::path& dir, const Settings& settings);
 
     void save(const MPS& mps, const double time);
 
+    /**
+     * @brief wait until all the files have been written
+     */
+    void finish();
+
+    /**
+     * @brief total wall-clock seconds spent in writing the files, in the background thread if the output is
+     * asynchronous
+     */
+    double getWriteSeconds() const;
+
     int getFileNumber() const;
+
+    /**
+     * @brief set the number of files already written, e.g. when restarting from a checkpoint
+     */
+    void setFileNumber(int fileNumber);
 };
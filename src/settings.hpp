@@ -2,9 +2,12 @@
 
 #include "common.hpp"
 #include "domain.hpp"
+#include "particle_field.hpp"
 
 #include <Eigen/Dense>
 #include <filesystem>
+#include <string>
+#include <vector>
 
 /**
  * @brief Struct for settings of calculation
@@ -47,7 +50,8 @@ struct Settings {
     double compressibility{};                  ///< Compressibility of the fluid for Implicit method
     double relaxationCoefficientForPressure{}; ///< Relaxation coefficient for pressure for Implicit method
     // for Explicit
-    double soundSpeed{}; ///< Speed of sound for Explicit method
+    double soundSpeed{};             ///< Speed of sound for Explicit method
+    bool fuseExplicitStages = false; ///< Flag for using the fused stages in a time step for Explicit method
 
     // collision
     double collisionDistance{};        ///< Distance for collision detection
@@ -59,7 +63,40 @@ struct Settings {
     double re_forLaplacian{};     ///< Effective radius for Laplacian
     double reMax{};               ///< Maximum of effective radius
 
+    // neighbor search
+    int neighborSearchInterval = 1; ///< Maximum number of time steps per neighbor search (only for fused Explicit)
+    double neighborSearchSkin{};    ///< Extra radius of neighbor search to keep neighbor lists valid for several steps
+    bool sparseBucket{};            ///< Flag for storing only the occupied cells of the bucket (SparseBucket)
+    int tileCells = 4;              ///< Number of cells of the bucket along an edge of a tile of TileScheduler
+
+    // ghost particles
+    int ghostCompactionInterval{}; ///< Number of time steps between removals of ghost particles (0: never removed)
+    bool ghostLog{};               ///< Flag for writing the particles that left the domain to ghost.log
+
     // i/o
     std::filesystem::path particlesPath; ///< Path for input particle file
     bool outputVtkInBinary{};            ///< Flag for saving VTK file in binary format
+    bool outputVtkCompressed{};          ///< Flag for compressing binary VTK file by zlib
+    bool asyncOutput = true;             ///< Flag for writing output files in a background thread
+
+    // checkpoint
+    bool checkpointAtEnd{};         ///< Flag for writing a checkpoint at the end of the simulation
+    int checkpointInterval{};       ///< Number of time steps between periodic checkpoints (0: not written)
+    double checkpointWallMinutes{}; ///< Wall-clock minutes between periodic checkpoints (0: not written)
+    int checkpointsKept = 3;        ///< Number of the newest checkpoint files kept (0: all of them are kept)
+
+    // progress report
+    int reportInterval = 1;     ///< Number of time steps between progress reports (0: only by reportWallSeconds)
+    double reportWallSeconds{}; ///< Wall-clock seconds between progress reports (0: only by reportInterval)
+    bool progressLog{};         ///< Flag for writing the progress reports to progress.jsonl in JSON lines
+    int traceSteps{};           ///< Number of time steps whose tasks are written to trace.json (0: not written)
+
+    // distributed mode
+    int loadBalanceInterval     = 50;  ///< Number of time steps between load balancing of the processes (0: never)
+    double loadBalanceThreshold = 0.1; ///< Imbalance of the work of the processes above which the slabs are moved
+
+    // output
+    std::vector<std::string> outputFormats  = {"prof", "vtu", "csv"}; ///< Formats of output files (or series)
+    std::vector<ParticleField> outputFields = allParticleFields();   ///< Fields written in VTK output files
+    bool outputVtkCells                     = true;                  ///< Flag for writing a cell per particle in VTK
 };
@@ -1,10 +1,14 @@
 #include "simulation.hpp"
 
+#include "checkpoint.hpp"
+#include "checkpoint_writer.hpp"
 #include "input.hpp"
 #include "mps_factory.hpp"
 #include "particles_loader/csv.hpp"
 
+#include <cmath>
 #include <cstdio>
+#include <functional>
 #include <iostream>
 #include <memory>
 
@@ -14,34 +18,124 @@ using std::endl;
 namespace fs     = std::filesystem;
 namespace chrono = std::chrono;
 
-Simulation::Simulation(fs::path& settingPath, fs::path& outputDirectory) {
-    Input input = loader.load(settingPath, outputDirectory);
-    saver       = Saver(outputDirectory, input.settings.outputVtkInBinary);
+Simulation::Simulation(fs::path& settingPath, fs::path& outputDirectory, const fs::path& restartPath) {
+    isRestarted           = !restartPath.empty();
+    this->outputDirectory = outputDirectory;
+    Input input           = loader.load(settingPath, outputDirectory, isRestarted);
+    saver                 = Saver(outputDirectory, input.settings);
 
-    mps          = MPSFactory::create(input);
-    startTime    = input.startTime;
-    time         = startTime;
-    endTime      = input.settings.endTime;
-    dt           = input.settings.dt;
-    outputPeriod = input.settings.outputPeriod;
+    // the particles are restored from the checkpoint instead of the particles file
+    Checkpoint checkpoint;
+    if (isRestarted) {
+        fs::path checkpointPath = restartPath;
+        // the newest valid checkpoint is used when a directory is given
+        if (fs::is_directory(restartPath)) {
+            checkpointPath = Checkpoint::findLatest(restartPath);
+            if (checkpointPath.empty()) {
+                cerr << "ERROR: no valid checkpoint file in " << fs::absolute(restartPath) << endl;
+                std::exit(-1);
+            }
+        }
+        cout << "Restart from checkpoint file: " << checkpointPath << endl;
+        auto [loadedCheckpoint, particles] = Checkpoint::read(checkpointPath);
+        checkpoint                         = std::move(loadedCheckpoint);
+        input.particles                    = std::move(particles);
+        input.startTime                    = checkpoint.startTime;
+    }
+
+    mps                   = MPSFactory::create(input);
+    startTime             = input.startTime;
+    time                  = startTime;
+    endTime               = input.settings.endTime;
+    dt                    = input.settings.dt;
+    outputPeriod          = input.settings.outputPeriod;
+    checkpointAtEnd       = input.settings.checkpointAtEnd;
+    checkpointInterval    = input.settings.checkpointInterval;
+    checkpointWallMinutes = input.settings.checkpointWallMinutes;
+    checkpointWriter      = std::make_unique<CheckpointWriter>(
+        outputDirectory / "checkpoint", input.settings.checkpointsKept, input.settings.asyncOutput
+    );
+
+    if (isRestarted) {
+        mps.restoreState(checkpoint.stepsSinceCompaction, std::move(checkpoint.neighborSearcherState));
+        saver.setFileNumber(checkpoint.fileNumber);
+        time     = checkpoint.time;
+        timeStep = checkpoint.timeStep;
+        cout << "Restart from t=" << time << "s (time step " << timeStep << ")" << endl;
+    }
+    runStartTime           = time;
+    runStartTimeStep       = timeStep;
+    lastCheckpointTimeStep = timeStep;
+    lastReportTimeStep     = timeStep;
+    reportInterval         = input.settings.reportInterval;
+    reportWallSeconds      = input.settings.reportWallSeconds;
+    traceSteps             = input.settings.traceSteps;
+
+    if (input.settings.ghostLog) {
+        // appended when restarted, so that the log covers the whole simulation
+        auto mode = isRestarted ? std::ios::app : std::ios::trunc;
+        ghostLog.open(outputDirectory / "ghost.log", std::ios::out | mode);
+        if (ghostLog.fail()) {
+            cerr << "ERROR: cannot write " << outputDirectory / "ghost.log" << endl;
+            std::exit(-1);
+        }
+        if (!isRestarted) {
+            ghostLog << "timeStep time id originalId x y z\n";
+        }
+    }
+
+    if (input.settings.progressLog) {
+        // appended when restarted, so that the log covers the whole simulation
+        auto mode = isRestarted ? std::ios::app : std::ios::trunc;
+        progressLog.open(outputDirectory / "progress.jsonl", std::ios::out | mode);
+        if (progressLog.fail()) {
+            cerr << "ERROR: cannot write " << outputDirectory / "progress.jsonl" << endl;
+            std::exit(-1);
+        }
+    }
 }
 
 void Simulation::run() {
     startSimulation();
-    saver.save(mps, time);
+    // the initial state has already been written before the checkpoint
+    if (!isRestarted) {
+        auto saveStartTime = chrono::system_clock::now();
+        saver.save(mps, time);
+        outputTime.waitSeconds += chrono::duration<double>(chrono::system_clock::now() - saveStartTime).count();
+    }
 
     while (time < endTime) {
         auto timeStepStartTime = chrono::system_clock::now();
+        auto traceStartTime    = chrono::steady_clock::now();
 
-        mps.stepForward();
         timeStep++;
         time += dt;
+        // The output is written in the time step, after the stages that write the particles.
+        std::function<void()> output;
+        if (saveCondition()) {
+            output = [&] { saver.save(mps, time); };
+        }
+        bool isTraced          = timeStep - runStartTimeStep <= traceSteps;
+        double stepWaitSeconds = mps.stepForward(output, isTraced ? &taskTrace : nullptr);
+        if (isTraced) {
+            taskTrace.add("TimeStep", 0, traceStartTime, chrono::steady_clock::now());
+        }
+        outputTime.waitSeconds += stepWaitSeconds;
 
+        // the time the step waited for the output is not counted in the time step, since it is reported separately
         auto timeStepEndTime = chrono::system_clock::now();
+        performanceReport.addStep(
+            chrono::duration<double>(timeStepEndTime - timeStepStartTime).count() - stepWaitSeconds,
+            mps.particles.size(),
+            mps.pressureCalculator->solverIterations()
+        );
 
-        timeStepReport(timeStepStartTime, timeStepEndTime);
-        if (saveCondition()) {
-            saver.save(mps, time);
+        if (reportCondition()) {
+            timeStepReport(timeStepStartTime, timeStepEndTime);
+        }
+        escapedParticlesReport();
+        if (checkpointCondition()) {
+            writeCheckpoint();
         }
     }
     endSimulation();
@@ -50,14 +144,46 @@ void Simulation::run() {
 void Simulation::startSimulation() {
     cout << endl;
     cout << "*** START SIMULATION ***" << endl;
-    realStartTime = chrono::system_clock::now();
+    realStartTime          = chrono::system_clock::now();
+    lastCheckpointRealTime = realStartTime;
+    lastReportRealTime     = realStartTime;
 }
 
 void Simulation::endSimulation() {
+    auto finishStartTime = chrono::system_clock::now();
+    saver.finish();
+    outputTime.waitSeconds += chrono::duration<double>(chrono::system_clock::now() - finishStartTime).count();
+    // the last time step may already have been written by a periodic checkpoint
+    if (checkpointAtEnd && lastCheckpointTimeStep != timeStep) {
+        writeCheckpoint(true);
+    }
+    finishStartTime = chrono::system_clock::now();
+    checkpointWriter->finish();
+    checkpointTime.waitSeconds += chrono::duration<double>(chrono::system_clock::now() - finishStartTime).count();
+    ghostLog.close();
+    progressLog.close();
+    if (traceSteps > 0 && !taskTrace.write(outputDirectory / "trace.json")) {
+        cerr << "WARNING: cannot write the trace to " << fs::absolute(outputDirectory / "trace.json") << endl;
+    }
     realEndTime = chrono::system_clock::now();
     cout << endl;
+    if (numEscapedTotal > 0) {
+        cout << numEscapedTotal << " particles left the domain" << endl;
+    }
     cout << "Total Simulation time = " << calHourMinuteSecond(realEndTime - realStartTime) << endl;
 
+    outputTime.writeSeconds     = saver.getWriteSeconds();
+    checkpointTime.writeSeconds = checkpointWriter->getWriteSeconds();
+    performanceReport.setWallSeconds(chrono::duration<double>(realEndTime - realStartTime).count());
+    performanceReport.setStageSeconds(mps.getStageSeconds());
+    performanceReport.setOutputTime(outputTime, checkpointTime);
+    performanceReport.setOutputBytes(PerformanceReport::directoryBytes(outputDirectory));
+    cout << endl;
+    cout << performanceReport.toTable();
+    if (!performanceReport.write(outputDirectory)) {
+        cerr << "WARNING: cannot write the performance report to " << fs::absolute(outputDirectory) << endl;
+    }
+
     cout << endl;
     cout << "*** END SIMULATION ***" << endl;
 }
@@ -68,16 +194,18 @@ void Simulation::timeStepReport(
     auto elapsedTime = timeStepEndTime - realStartTime;
     auto elapsed     = "elapsed=" + calHourMinuteSecond(elapsedTime);
 
-    double ave = 0.0;
-    if (timeStep != 0) {
-        ave = (double) (chrono::duration_cast<chrono::nanoseconds>(elapsedTime).count()) / (timeStep * 1e9);
+    // only the time steps of this run are counted when restarted
+    int runTimeStep = timeStep - runStartTimeStep;
+    double ave      = 0.0;
+    if (runTimeStep != 0) {
+        ave = (double) (chrono::duration_cast<chrono::nanoseconds>(elapsedTime).count()) / (runTimeStep * 1e9);
     }
 
     std::string remain = "remain=";
-    if (timeStep == 0) {
+    if (runTimeStep == 0) {
         remain += "-h --m --s";
     } else {
-        auto totalTime = chrono::nanoseconds((int64_t) (ave * (endTime - startTime) / dt * 1e9));
+        auto totalTime = chrono::nanoseconds((int64_t) (ave * (endTime - runStartTime) / dt * 1e9));
         remain += calHourMinuteSecond(totalTime - elapsedTime);
     }
     double last = chrono::duration_cast<chrono::nanoseconds>(timeStepEndTime - timeStepStartTime).count() * 1e-9;
@@ -100,6 +228,110 @@ void Simulation::timeStepReport(
 
     // error output
     fprintf(stderr, "%4d: t=%.3lfs\n", timeStep, time);
+
+    // throughput over the time steps since the last report
+    double reportSeconds      = chrono::duration<double>(timeStepEndTime - lastReportRealTime).count();
+    double particlesPerSecond = 0.0;
+    if (reportSeconds > 0.0) {
+        particlesPerSecond = (double) mps.particles.size() * (timeStep - lastReportTimeStep) / reportSeconds;
+    }
+    lastReportTimeStep = timeStep;
+    lastReportRealTime = timeStepEndTime;
+
+    // machine-readable output
+    if (progressLog.is_open()) {
+        // NaN and infinity are not allowed in JSON
+        char courant[32] = "null";
+        if (std::isfinite(mps.courant)) {
+            snprintf(courant, sizeof(courant), "%.6g", mps.courant);
+        }
+        char line[512];
+        snprintf(
+            line,
+            sizeof(line),
+            "{\"timeStep\":%d,\"time\":%.9g,\"dt\":%.9g,\"elapsedSeconds\":%.6f,\"stepSeconds\":%.6f,"
+            "\"averageStepSeconds\":%.6f,\"courant\":%s,\"solverIterations\":%d,\"particles\":%d,"
+            "\"particlesPerSecond\":%.6g,\"files\":%d}\n",
+            timeStep,
+            time,
+            dt,
+            chrono::duration<double>(elapsedTime).count(),
+            last,
+            ave,
+            courant,
+            mps.pressureCalculator->solverIterations(),
+            mps.particles.size(),
+            particlesPerSecond,
+            saver.getFileNumber()
+        );
+        // flushed so that the progress can be followed while running
+        progressLog << line << std::flush;
+    }
+}
+
+void Simulation::escapedParticlesReport() {
+    auto escapedParticles = mps.takeEscapedParticles();
+    if (escapedParticles.empty())
+        return;
+
+    numEscapedTotal += escapedParticles.size();
+    fprintf(
+        stderr,
+        "WARNING: %zu particles left the domain and became ghost particles at t=%.3lfs\n",
+        escapedParticles.size(),
+        time
+    );
+    if (ghostLog.is_open()) {
+        // written with '\n' instead of endl so that the lines are buffered
+        for (const auto& p : escapedParticles) {
+            ghostLog << timeStep << " " << time << " " << p.id << " " << p.originalId << " " << p.position.x() << " "
+                     << p.position.y() << " " << p.position.z() << "\n";
+        }
+    }
+}
+
+void Simulation::writeCheckpoint(const bool isLast) {
+    auto checkpointStartTime = chrono::system_clock::now();
+    Checkpoint checkpoint;
+    checkpoint.startTime             = startTime;
+    checkpoint.time                  = time;
+    checkpoint.timeStep              = timeStep;
+    checkpoint.fileNumber            = saver.getFileNumber();
+    checkpoint.stepsSinceCompaction  = mps.getStepsSinceCompaction();
+    checkpoint.neighborSearcherState = mps.getNeighborSearcher().getState();
+    checkpoint.hasNeighbors          = mps.getNeighborSearcher().reusesNeighbors();
+    checkpointWriter->write(checkpoint, mps.particles, isLast);
+
+    lastCheckpointTimeStep = timeStep;
+    lastCheckpointRealTime = chrono::system_clock::now();
+    checkpointTime.waitSeconds += chrono::duration<double>(lastCheckpointRealTime - checkpointStartTime).count();
+}
+
+bool Simulation::checkpointCondition() {
+    // multiples of the interval, so that the time steps of checkpoints do not change by restarting
+    if (checkpointInterval > 0 && timeStep % checkpointInterval == 0)
+        return true;
+
+    if (checkpointWallMinutes > 0.0) {
+        chrono::duration<double, std::ratio<60>> elapsed = chrono::system_clock::now() - lastCheckpointRealTime;
+        return elapsed.count() >= checkpointWallMinutes;
+    }
+    return false;
+}
+
+bool Simulation::reportCondition() {
+    // the last time step is always reported
+    if (time >= endTime)
+        return true;
+
+    if (reportInterval > 0 && timeStep % reportInterval == 0)
+        return true;
+
+    if (reportWallSeconds > 0.0) {
+        chrono::duration<double> elapsed = chrono::system_clock::now() - lastReportRealTime;
+        return elapsed.count() >= reportWallSeconds;
+    }
+    return false;
 }
 
 bool Simulation::saveCondition() {
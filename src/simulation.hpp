@@ -1,13 +1,18 @@
 #pragma once
 
 #include "common.hpp"
+#include "checkpoint_writer.hpp"
 #include "loader.hpp"
 #include "mps.hpp"
+#include "performance_report.hpp"
 #include "saver.hpp"
+#include "task_trace.hpp"
 
 #include <chrono>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -32,11 +37,49 @@ public:
     double outputPeriod;
     int timeStep = 0;
 
-    Simulation(std::filesystem::path& settingPath, std::filesystem::path& outputDirectory);
+    /**
+     * @param settingPath path to the setting file
+     * @param outputDirectory path to the output directory
+     * @param restartPath path to a checkpoint file to restart the simulation from, or a directory of checkpoint files
+     * to restart from the newest valid one. The simulation starts from the particles file in the settings if it is
+     * empty.
+     */
+    Simulation(
+        std::filesystem::path& settingPath,
+        std::filesystem::path& outputDirectory,
+        const std::filesystem::path& restartPath = {}
+    );
 
     void run();
 
 private:
+    std::unique_ptr<CheckpointWriter> checkpointWriter;           ///< writes checkpoints to the "checkpoint" directory
+    std::chrono::system_clock::time_point lastCheckpointRealTime; ///< wall-clock time of the last checkpoint
+
+    bool checkpointAtEnd{};         ///< whether a checkpoint is written at the end of the simulation
+    int checkpointInterval{};       ///< number of time steps between periodic checkpoints (0: not written)
+    double checkpointWallMinutes{}; ///< wall-clock minutes between periodic checkpoints (0: not written)
+    int lastCheckpointTimeStep{};   ///< time step of the last checkpoint (the start of this run if none)
+    bool isRestarted = false;       ///< whether the simulation is restarted from a checkpoint
+    double runStartTime{};          ///< time when this run started (the checkpoint time when restarted)
+    int runStartTimeStep{};         ///< time step when this run started
+
+    std::ofstream ghostLog;   ///< details of the particles that left the domain (open if it is written)
+    size_t numEscapedTotal{}; ///< number of particles that have left the domain in this run
+
+    int reportInterval = 1;                                   ///< number of time steps between progress reports
+    double reportWallSeconds{};                               ///< wall-clock seconds between progress reports
+    int lastReportTimeStep{};                                 ///< time step of the last progress report
+    std::chrono::system_clock::time_point lastReportRealTime; ///< wall-clock time of the last progress report
+    std::ofstream progressLog;                                ///< progress reports in JSON lines (open if written)
+    int traceSteps{};                                         ///< number of time steps of this run that are traced
+    TaskTrace taskTrace;                                      ///< tasks of the time steps written to trace.json
+
+    std::filesystem::path outputDirectory;        ///< directory where the results are written
+    PerformanceReport performanceReport;          ///< performance statistics of this run
+    PerformanceReport::OutputTime outputTime;     ///< time spent in writing output files
+    PerformanceReport::OutputTime checkpointTime; ///< time spent in writing checkpoints
+
     void startSimulation();
 
     template <typename Rep, typename Period> std::string calHourMinuteSecond(std::chrono::duration<Rep, Period> d) {
@@ -56,14 +99,40 @@ private:
 
     /**
      * @brief Report time step information to the console
+     * @details The throughput (particles per second) is averaged over the time steps since the last report. The report
+     * is also written to #progressLog as a line of JSON if it is open.
      */
     void timeStepReport(
         const std::chrono::system_clock::time_point& timeStepStartTime,
         const std::chrono::system_clock::time_point& timeStepEndTime
     );
 
+    /**
+     * @brief whether the progress is reported after this time step
+     * @details Reported every #reportInterval time steps and every #reportWallSeconds seconds, and always at the last
+     * time step.
+     */
+    bool reportCondition();
+
     bool saveCondition();
 
+    /**
+     * @brief report the particles that have left the domain in this time step
+     * @details One line of summary is written to the standard error, and the details to #ghostLog if it is open.
+     */
+    void escapedParticlesReport();
+
+    /**
+     * @brief write a checkpoint of the current state by #checkpointWriter
+     * @param isLast whether it is written at the end of the simulation (see CheckpointWriter::write())
+     */
+    void writeCheckpoint(const bool isLast = false);
+
+    /**
+     * @brief whether a periodic checkpoint is due after this time step
+     */
+    bool checkpointCondition();
+
     // NOTE: If this function is also needed in other classes, it should be moved to a separate file.
     std::string getCurrentTimeString();
 };
@@ -0,0 +1,97 @@
+#include "sparse_bucket.hpp"
+
+SparseBucket::SparseBucket(const double& reMax, const Domain& domain, const size_t& particleSize) {
+    this->length = reMax;
+    this->domain = domain;
+
+    this->numX = (int64_t) (domain.xLength / length) + 3;
+    this->numY = (int64_t) (domain.yLength / length) + 3;
+
+    this->cells.resize(minCapacity);
+    this->next.resize(particleSize);
+}
+
+void SparseBucket::storeParticles(Particles& particles) {
+    // The table is sized for the cells occupied in the previous call, so it shrinks when the fluid gathers and grows
+    // when it spreads. The load factor is kept at most 1/2.
+    size_t newCapacity = minCapacity;
+    while (newCapacity < 4 * occupied) {
+        newCapacity *= 2;
+    }
+    if (newCapacity != cells.size()) {
+        cells = std::vector<Cell>(newCapacity);
+    } else {
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(cells.size()); i++) {
+            cells[i] = Cell();
+        }
+    }
+    occupied = 0;
+
+    // the number of particles can grow, e.g. when particles move in from other processes in the distributed mode
+    next.resize(particles.size());
+#pragma omp parallel for
+    for (int i = 0; i < particles.size(); i++) {
+        next[i] = -1;
+    }
+
+    for (auto& p : particles) {
+        if (p.type == ParticleType::Ghost)
+            continue;
+
+        int64_t ix  = (int64_t) ((p.position.x() - domain.xMin) / length) + 1;
+        int64_t iy  = (int64_t) ((p.position.y() - domain.yMin) / length) + 1;
+        int64_t iz  = (int64_t) ((p.position.z() - domain.zMin) / length) + 1;
+        int64_t key = ix + iy * numX + iz * numX * numY;
+
+        size_t slot = findSlot(key);
+        if (cells[slot].key == -1) {
+            occupied++;
+            if (2 * occupied > cells.size()) {
+                rehash(2 * cells.size());
+                slot = findSlot(key);
+            }
+            cells[slot].key = key;
+        }
+
+        Cell& cell = cells[slot];
+        if (cell.last == -1)
+            cell.first = p.id;
+        else
+            next[cell.last] = p.id;
+        cell.last = p.id;
+    }
+}
+
+int SparseBucket::getFirst(const int& ix, const int& iy, const int& iz) const {
+    int64_t key = ix + iy * numX + iz * numX * numY;
+    return cells[findSlot(key)].first;
+}
+
+size_t SparseBucket::numOccupied() const {
+    return occupied;
+}
+
+size_t SparseBucket::capacity() const {
+    return cells.size();
+}
+
+size_t SparseBucket::findSlot(const int64_t& key) const {
+    // Fibonacci hashing spreads the neighboring cells over the table, and linear probing finds the cell
+    size_t mask = cells.size() - 1;
+    size_t slot = static_cast<size_t>(static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL >> 17) & mask;
+    while (cells[slot].key != key && cells[slot].key != -1) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void SparseBucket::rehash(const size_t& newCapacity) {
+    std::vector<Cell> oldCells = std::move(cells);
+    cells                      = std::vector<Cell>(newCapacity);
+    for (const auto& cell : oldCells) {
+        if (cell.key != -1) {
+            cells[findSlot(cell.key)] = cell;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common.hpp"
+#include "domain.hpp"
+#include "particles.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Bucket for neighbor search that stores only the occupied cells
+ *
+ * @details Bucket allocates and clears all the cells of the domain in every search, which is a waste when the fluid
+ * occupies a small part of a large domain. SparseBucket keeps the occupied cells in a hash table with open addressing
+ * instead, so its memory and the cost of clearing it scale with the number of occupied cells. The particles in a cell
+ * are linked in the same order as in Bucket, so both give the same neighbor lists.
+ */
+class SparseBucket {
+public:
+    double length{};
+    Domain domain{};
+    std::vector<int> next; ///< next particle in the same cell (-1: last one)
+
+    SparseBucket() = default;
+
+    /**
+     * @param reMax length of the cells
+     * @param domain domain of the simulation
+     * @param particleSize number of particles
+     */
+    SparseBucket(const double& reMax, const Domain& domain, const size_t& particleSize);
+
+    /**
+     * @brief store particles in the bucket
+     * @param particles particles to be stored. Particles out of the domain have to be ghost particles (see
+     * NeighborSearcher::ghostParticlesOutOfDomain()).
+     */
+    void storeParticles(Particles& particles);
+
+    /**
+     * @brief first particle in the cell
+     * @param ix index of the cell in x direction (Bucket's index, which starts from 1 in the domain)
+     * @param iy index of the cell in y direction
+     * @param iz index of the cell in z direction
+     * @return id of the particle, or -1 if the cell is empty
+     */
+    int getFirst(const int& ix, const int& iy, const int& iz) const;
+
+    /**
+     * @brief number of occupied cells
+     */
+    size_t numOccupied() const;
+
+    /**
+     * @brief number of slots of the hash table
+     */
+    size_t capacity() const;
+
+private:
+    /// @brief slot of the hash table
+    struct Cell {
+        int64_t key = -1; ///< index of the cell in the domain (-1: empty slot)
+        int first   = -1; ///< first particle in the cell
+        int last    = -1; ///< last particle in the cell
+    };
+
+    static constexpr size_t minCapacity = 64; ///< minimum number of slots
+
+    int64_t numX{}, numY{};
+    std::vector<Cell> cells; ///< hash table of the occupied cells. Its size is a power of two.
+    size_t occupied{};       ///< number of occupied cells
+
+    /**
+     * @brief slot of the cell, or the empty slot where it would be inserted
+     */
+    size_t findSlot(const int64_t& key) const;
+
+    /**
+     * @brief change the number of slots keeping the occupied cells
+     */
+    void rehash(const size_t& newCapacity);
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Stage of a time step in the MPS method
+ *
+ * @details MPS::stepForward() runs a sequence of these stages. The sequence is declared by the pressure calculator
+ * (see PressureCalculator::Interface::stepStages()), so that each pressure calculation scheme can add the stages it
+ * needs without the MPS class checking which scheme is used.
+ */
+enum class StepStage {
+    SearchNeighbors,                   ///< search neighbors of each particle
+    UpdateNeighbors,                   ///< search neighbors only when the neighbor lists may be outdated, otherwise
+                                       ///< update the distances (see NeighborSearcher::updateNeighbors())
+    Gravity,                           ///< add gravity to the acceleration
+    Viscosity,                         ///< add viscosity term to the acceleration
+    MoveParticle,                      ///< move particles in the prediction step
+    Collision,                         ///< resolve collision between particles that are too close
+    NumberDensity,                     ///< calculate number density from the neighbor distances
+    Pressure,                          ///< calculate pressure by the pressure calculator
+    MinimumPressure,                   ///< set minimum pressure for the pressure gradient
+    PressureGradient,                  ///< add pressure gradient term to the acceleration
+    MoveParticleUsingPressureGradient, ///< move particles in the correction step
+    UpdateNumberDensity,               ///< update neighbor distances to the current positions and recalculate number
+                                       ///< density without searching neighbors again
+    Courant,                           ///< calculate Courant number
+
+    // Fused stages for the explicit scheme. They reuse the neighbor list of the UpdateNeighbors stage at the beginning
+    // of the step and measure distances at the current positions, so no other neighbor search is needed in the step.
+    FusedPrediction, ///< Gravity, Viscosity and MoveParticle in a single pass over the neighbors
+    FusedCollision,  ///< Collision with the distances measured at the current positions
+    FusedCorrection, ///< MinimumPressure, PressureGradient and MoveParticleUsingPressureGradient in a single pass over
+                     ///< the neighbors
+};
+
+/**
+ * @brief name of the stage, e.g. for performance reports
+ */
+inline std::string stepStageName(const StepStage& stage) {
+    switch (stage) {
+    case StepStage::SearchNeighbors:
+        return "SearchNeighbors";
+    case StepStage::UpdateNeighbors:
+        return "UpdateNeighbors";
+    case StepStage::Gravity:
+        return "Gravity";
+    case StepStage::Viscosity:
+        return "Viscosity";
+    case StepStage::MoveParticle:
+        return "MoveParticle";
+    case StepStage::Collision:
+        return "Collision";
+    case StepStage::NumberDensity:
+        return "NumberDensity";
+    case StepStage::Pressure:
+        return "Pressure";
+    case StepStage::MinimumPressure:
+        return "MinimumPressure";
+    case StepStage::PressureGradient:
+        return "PressureGradient";
+    case StepStage::MoveParticleUsingPressureGradient:
+        return "MoveParticleUsingPressureGradient";
+    case StepStage::UpdateNumberDensity:
+        return "UpdateNumberDensity";
+    case StepStage::Courant:
+        return "Courant";
+    case StepStage::FusedPrediction:
+        return "FusedPrediction";
+    case StepStage::FusedCollision:
+        return "FusedCollision";
+    case StepStage::FusedCorrection:
+        return "FusedCorrection";
+    }
+    return "";
+}
+
+/**
+ * @brief Data of the particles accessed by the stages
+ */
+enum class ParticleData {
+    Type,              ///< type, which the neighbor search changes when a particle leaves the domain
+    Neighbors,         ///< neighbor lists and the distances in them
+    Position,          ///< position
+    Velocity,          ///< velocity
+    Acceleration,      ///< acceleration
+    NumberDensity,     ///< number density
+    BoundaryCondition, ///< boundary condition of the pressure
+    Pressure,          ///< pressure
+    MinimumPressure,   ///< minimum pressure among the neighbors
+};
+
+/**
+ * @brief Data of the particles read and written by a stage
+ */
+struct StageAccess {
+    std::vector<ParticleData> reads;  ///< data read by the stage
+    std::vector<ParticleData> writes; ///< data written by the stage
+};
+
+/**
+ * @brief data of the particles read and written by the stage
+ * @details A stage that only adds to the data, e.g. Gravity to the acceleration, also reads it.
+ */
+inline StageAccess stepStageAccess(const StepStage& stage) {
+    using D = ParticleData;
+    switch (stage) {
+    case StepStage::SearchNeighbors:
+    case StepStage::UpdateNeighbors:
+        return {{D::Type, D::Neighbors, D::Position}, {D::Type, D::Neighbors}};
+    case StepStage::Gravity:
+        return {{D::Type, D::Acceleration}, {D::Acceleration}};
+    case StepStage::Viscosity:
+        return {{D::Type, D::Neighbors, D::Position, D::Velocity, D::Acceleration}, {D::Acceleration}};
+    case StepStage::MoveParticle:
+    case StepStage::MoveParticleUsingPressureGradient:
+        return {{D::Type, D::Position, D::Velocity, D::Acceleration}, {D::Position, D::Velocity, D::Acceleration}};
+    case StepStage::Collision:
+    case StepStage::FusedCollision:
+        return {{D::Type, D::Neighbors, D::Position, D::Velocity}, {D::Neighbors, D::Position, D::Velocity}};
+    case StepStage::NumberDensity:
+        return {{D::Type, D::Neighbors}, {D::NumberDensity}};
+    case StepStage::Pressure:
+        return {{D::Type, D::Neighbors, D::Position, D::NumberDensity}, {D::BoundaryCondition, D::Pressure}};
+    case StepStage::MinimumPressure:
+        return {{D::Type, D::Neighbors, D::Pressure}, {D::MinimumPressure}};
+    case StepStage::PressureGradient:
+        return {
+            {D::Type, D::Neighbors, D::Position, D::Pressure, D::MinimumPressure, D::Acceleration}, {D::Acceleration}
+        };
+    case StepStage::UpdateNumberDensity:
+        return {{D::Type, D::Neighbors, D::Position}, {D::Neighbors, D::NumberDensity}};
+    case StepStage::Courant:
+        return {{D::Type, D::Velocity}, {}};
+    case StepStage::FusedPrediction:
+        return {
+            {D::Type, D::Neighbors, D::Position, D::Velocity, D::Acceleration},
+            {D::Position, D::Velocity, D::Acceleration}
+        };
+    case StepStage::FusedCorrection:
+        return {
+            {D::Type, D::Neighbors, D::Position, D::Velocity, D::Pressure, D::Acceleration},
+            {D::MinimumPressure, D::Position, D::Velocity, D::Acceleration}
+        };
+    }
+    return {};
+}
+
+/**
+ * @brief whether the stage starts parallel regions of its own, instead of looping over the particles with
+ * MPS::forEachParticle()
+ * @details Such a stage is run alone, so that its loops use all the threads (see TaskGraph).
+ */
+inline bool stepStageRunsAlone(const StepStage& stage) {
+    switch (stage) {
+    case StepStage::SearchNeighbors:
+    case StepStage::UpdateNeighbors:
+    case StepStage::Pressure:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief whether a stage has to wait for an earlier stage to finish
+ * @details It does when either of them writes data that the other accesses. Otherwise they can run at the same time.
+ * @param later access of the later stage
+ * @param earlier access of the earlier stage
+ */
+inline bool stepStageDependsOn(const StageAccess& later, const StageAccess& earlier) {
+    auto overlaps = [](const std::vector<ParticleData>& a, const std::vector<ParticleData>& b) {
+        return std::any_of(a.begin(), a.end(), [&](const ParticleData& d) {
+            return std::find(b.begin(), b.end(), d) != b.end();
+        });
+    };
+    return overlaps(later.reads, earlier.writes) || overlaps(later.writes, earlier.reads) ||
+           overlaps(later.writes, earlier.writes);
+}
@@ -0,0 +1,132 @@
+#include "task_graph.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using std::cerr;
+using std::endl;
+
+int TaskGraph::add(
+    const std::string& name,
+    const std::function<void()>& function,
+    const std::vector<int>& dependencies,
+    const bool runsAlone
+) {
+    int id = static_cast<int>(tasks.size());
+    Task task;
+    task.name            = name;
+    task.function        = function;
+    task.numDependencies = static_cast<int>(dependencies.size());
+    task.runsAlone       = runsAlone;
+    for (const auto& dependency : dependencies) {
+        // the tasks are added in an order they can be run, so that the graph has no cycle
+        if (dependency < 0 || dependency >= id) {
+            cerr << "ERROR: task " << name << " depends on task " << dependency << " that has not been added" << endl;
+            std::exit(-1);
+        }
+        tasks[dependency].successors.push_back(id);
+    }
+    tasks.push_back(task);
+    return id;
+}
+
+void TaskGraph::run(TaskTrace* trace) {
+    std::vector<int> remaining(tasks.size());
+    std::vector<int> ready;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        remaining[i] = tasks[i].numDependencies;
+        if (remaining[i] == 0) {
+            ready.push_back(static_cast<int>(i));
+        }
+    }
+
+    while (!ready.empty()) {
+        std::vector<int> shared;
+        for (const auto& id : ready) {
+            if (tasks[id].runsAlone) {
+                execute(id);
+            } else {
+                shared.push_back(id);
+            }
+        }
+
+        if (shared.size() == 1) {
+            execute(shared.front());
+        } else if (shared.size() > 1) {
+#pragma omp parallel
+#pragma omp single
+            for (const int id : shared) {
+#pragma omp task
+                execute(id);
+            }
+        }
+
+        std::vector<int> next;
+        for (const auto& id : ready) {
+            for (const auto& successor : tasks[id].successors) {
+                if (--remaining[successor] == 0) {
+                    next.push_back(successor);
+                }
+            }
+        }
+        ready = std::move(next);
+    }
+
+    if (trace != nullptr) {
+        for (const auto& task : tasks) {
+            trace->add(task.name, task.thread, task.start, task.end);
+        }
+    }
+}
+
+double TaskGraph::getSeconds(const int id) const {
+    return std::chrono::duration<double>(tasks[id].end - tasks[id].start).count();
+}
+
+double TaskGraph::getExclusiveSeconds(const int id) const {
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    // the parts of the other tasks that overlap the task, merged in the order they start
+    const auto& task = tasks[id];
+    std::vector<std::pair<TimePoint, TimePoint>> overlaps;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        TimePoint start = std::max(tasks[i].start, task.start);
+        TimePoint end   = std::min(tasks[i].end, task.end);
+        if (static_cast<int>(i) != id && start < end) {
+            overlaps.emplace_back(start, end);
+        }
+    }
+    std::sort(overlaps.begin(), overlaps.end());
+
+    auto exclusive  = task.end - task.start;
+    TimePoint until = task.start; // end of the overlaps subtracted so far
+    for (const auto& [start, end] : overlaps) {
+        if (end > until) {
+            exclusive -= end - std::max(start, until);
+            until = end;
+        }
+    }
+    return std::chrono::duration<double>(exclusive).count();
+}
+
+int TaskGraph::size() const {
+    return static_cast<int>(tasks.size());
+}
+
+void TaskGraph::execute(const int id) {
+    auto& task  = tasks[id];
+    task.thread = 0;
+#ifdef _OPENMP
+    task.thread = omp_get_thread_num();
+#endif
+
+    task.start = std::chrono::steady_clock::now();
+    task.function();
+    task.end = std::chrono::steady_clock::now();
+}
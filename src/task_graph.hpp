@@ -0,0 +1,81 @@
+#pragma once
+
+#include "common.hpp"
+#include "task_trace.hpp"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Graph of tasks that depend on each other
+ *
+ * @details The tasks are run in rounds. All the tasks whose dependencies have finished are run in the same round, as
+ * OpenMP tasks taken by idle threads when there are several of them. A parallel region started in such a task runs on
+ * a single thread, so the tasks that start their own parallel regions are added with runsAlone and are called one
+ * after another on the calling thread, outside of a parallel region, before the other tasks of the round. The other
+ * tasks may only contain loops that share the threads of the round, e.g. TileScheduler::forEach(), which creates a
+ * task for each thread of the team when it is called in a parallel region.
+ */
+class TaskGraph {
+public:
+    /**
+     * @brief add a task
+     * @param name name of the task, e.g. for the trace
+     * @param function function that runs the task
+     * @param dependencies tasks that must finish before the task starts. They must have been added before.
+     * @param runsAlone whether the task starts parallel regions of its own, which need all the threads
+     * @return id of the task
+     */
+    int add(
+        const std::string& name,
+        const std::function<void()>& function,
+        const std::vector<int>& dependencies = {},
+        const bool runsAlone                 = false
+    );
+
+    /**
+     * @brief run all the tasks
+     * @param trace trace to add the tasks to (null: not traced)
+     */
+    void run(TaskTrace* trace = nullptr);
+
+    /**
+     * @brief wall-clock seconds the task took in the last run()
+     * @param id id of the task
+     */
+    double getSeconds(const int id) const;
+
+    /**
+     * @brief wall-clock seconds in which the task ran while none of the other tasks did in the last run()
+     * @details It is the time the graph waited only for the task, e.g. for the output of a time step.
+     * @param id id of the task
+     */
+    double getExclusiveSeconds(const int id) const;
+
+    /**
+     * @brief number of the tasks
+     */
+    int size() const;
+
+private:
+    /// @brief a node of the graph
+    struct Task {
+        std::string name;                            ///< name of the task
+        std::function<void()> function;              ///< function that runs the task
+        std::vector<int> successors;                 ///< tasks that depend on this task
+        int numDependencies{};                       ///< number of the tasks this task depends on
+        bool runsAlone{};                            ///< whether the task starts parallel regions of its own
+        int thread{};                                ///< thread that ran the task in the last run()
+        std::chrono::steady_clock::time_point start; ///< time when the task started in the last run()
+        std::chrono::steady_clock::time_point end;   ///< time when the task ended in the last run()
+    };
+
+    std::vector<Task> tasks; ///< tasks in the order they were added
+
+    /**
+     * @brief run the task and record the time it took
+     */
+    void execute(const int id);
+};
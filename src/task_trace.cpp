@@ -0,0 +1,50 @@
+#include "task_trace.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+TaskTrace::TaskTrace() {
+    this->origin = std::chrono::steady_clock::now();
+}
+
+void TaskTrace::add(
+    const std::string& name,
+    const int thread,
+    const std::chrono::steady_clock::time_point& start,
+    const std::chrono::steady_clock::time_point& end
+) {
+    double startMicros    = std::chrono::duration<double, std::micro>(start - origin).count();
+    double durationMicros = std::chrono::duration<double, std::micro>(end - start).count();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back(Event{name, thread, startMicros, durationMicros});
+}
+
+size_t TaskTrace::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return events.size();
+}
+
+std::string TaskTrace::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::stringstream json;
+    json << std::fixed << std::setprecision(3);
+    // "X" is a complete event, which has both the start and the duration.
+    json << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (size_t i = 0; i < events.size(); i++) {
+        const auto& e = events[i];
+        json << (i == 0 ? "\n" : ",\n");
+        json << "  {\"name\": \"" << e.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << e.thread
+             << ", \"ts\": " << e.startMicros << ", \"dur\": " << e.durationMicros << "}";
+    }
+    json << "\n]}\n";
+    return json.str();
+}
+
+bool TaskTrace::write(const std::filesystem::path& path) const {
+    std::ofstream file(path);
+    file << toJson();
+    file.close();
+    return !file.fail();
+}
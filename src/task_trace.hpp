@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Timeline of the tasks run by each thread
+ *
+ * @details The tasks of TaskGraph and the time steps are added while the simulation runs, and written in the Trace
+ * Event Format, which is shown by Perfetto (https://ui.perfetto.dev) or chrome://tracing. The gaps in the timeline of a
+ * thread are the time it waited for the other threads.
+ */
+class TaskTrace {
+public:
+    TaskTrace();
+
+    /**
+     * @brief add a task that has been run
+     * @details It may be called from several threads at the same time.
+     * @param name name of the task
+     * @param thread number of the thread that ran the task
+     * @param start time when the task started
+     * @param end time when the task ended
+     */
+    void add(
+        const std::string& name,
+        const int thread,
+        const std::chrono::steady_clock::time_point& start,
+        const std::chrono::steady_clock::time_point& end
+    );
+
+    /**
+     * @brief number of the tasks added
+     */
+    size_t size() const;
+
+    /**
+     * @brief the trace in the Trace Event Format (JSON)
+     */
+    std::string toJson() const;
+
+    /**
+     * @brief write the trace to the file
+     * @return whether it has been written
+     */
+    bool write(const std::filesystem::path& path) const;
+
+private:
+    /// @brief a task in the timeline
+    struct Event {
+        std::string name;      ///< name of the task
+        int thread;            ///< number of the thread that ran the task
+        double startMicros;    ///< microseconds from the creation of the trace to the start of the task
+        double durationMicros; ///< microseconds the task took
+    };
+
+    std::chrono::steady_clock::time_point origin; ///< time when the trace was created
+    std::vector<Event> events;                    ///< tasks added so far
+    mutable std::mutex mutex;                     ///< lock of #events
+};
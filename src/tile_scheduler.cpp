@@ -0,0 +1,75 @@
+#include "tile_scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+TileScheduler::TileScheduler(const Domain& domain, const double tileWidth) {
+    this->domain    = domain;
+    this->tileWidth = tileWidth;
+    this->numX      = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(domain.xLength / tileWidth)));
+    this->numY      = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(domain.yLength / tileWidth)));
+    this->numZ      = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(domain.zLength / tileWidth)));
+}
+
+void TileScheduler::build(const Particles& particles, const int numThreads) {
+    // The particles are sorted by the keys of their tiles, which are ordered with x fastest, so that the tiles of a
+    // thread are next to each other. Only the occupied tiles are stored, in the order of the keys.
+    std::vector<std::pair<int64_t, int>> keys(particles.size());
+    for (const auto& p : particles) {
+        // ghost particles may be out of the domain, so the indices are clamped
+        int64_t ix = std::clamp(static_cast<int64_t>((p.position.x() - domain.xMin) / tileWidth), int64_t{0}, numX - 1);
+        int64_t iy = std::clamp(static_cast<int64_t>((p.position.y() - domain.yMin) / tileWidth), int64_t{0}, numY - 1);
+        int64_t iz = std::clamp(static_cast<int64_t>((p.position.z() - domain.zMin) / tileWidth), int64_t{0}, numZ - 1);
+        keys[p.id] = {ix + numX * (iy + numY * iz), p.id};
+    }
+    // the ids break the ties, so the particles of a tile are in the order of the ids
+    std::sort(keys.begin(), keys.end());
+
+    order.resize(particles.size());
+    tileOffsets.clear();
+    std::vector<double> tileWork;
+    for (int i = 0; i < static_cast<int>(keys.size()); i++) {
+        if (i == 0 || keys[i].first != keys[i - 1].first) {
+            tileOffsets.push_back(i);
+            tileWork.push_back(0.0);
+        }
+        order[i] = keys[i].second;
+        tileWork.back() += 1.0 + static_cast<double>(particles[keys[i].second].neighbors.size());
+    }
+    int numTiles = static_cast<int>(tileWork.size());
+    tileOffsets.push_back(static_cast<int>(particles.size()));
+
+    // Each thread takes the consecutive tiles whose work adds up to its share.
+    double totalWork = 0.0;
+    for (const auto& work : tileWork) {
+        totalWork += work;
+    }
+    int threads = std::max(1, numThreads);
+    threadTiles.assign(threads + 1, numTiles);
+    threadTiles[0]    = 0;
+    double cumulative = 0.0;
+    int thread        = 1;
+    for (int tile = 0; tile < numTiles && thread < threads; tile++) {
+        cumulative += tileWork[tile];
+        while (thread < threads && cumulative >= totalWork * thread / threads) {
+            threadTiles[thread++] = tile + 1;
+        }
+    }
+}
+
+int TileScheduler::numParticles() const {
+    return static_cast<int>(order.size());
+}
+
+const std::vector<int>& TileScheduler::getOrder() const {
+    return order;
+}
+
+const std::vector<int>& TileScheduler::getTileOffsets() const {
+    return tileOffsets;
+}
+
+const std::vector<int>& TileScheduler::getThreadTiles() const {
+    return threadTiles;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "common.hpp"
+#include "domain.hpp"
+#include "particles.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * @brief Scheduler of the loops over particles in spatial tiles
+ *
+ * @details The domain is divided into cubic tiles of several cells of the bucket, and the particles are grouped by the
+ * tile they are in. Only the tiles that contain particles are stored, so a large domain that is mostly empty costs no
+ * more than the particles in it. Consecutive tiles are assigned to each thread so that the work of the threads,
+ * estimated by the number of neighbors, is the same. The same assignment is used in all the loops until the next
+ * build(), so each thread works on the same region of the domain and its particles and their neighbors stay in the
+ * cache of the thread between the loops. A thread that has finished its tiles takes the remaining tiles of the other
+ * threads, so that the holes in the fluid, e.g. near the free surface, do not leave the threads idle.
+ */
+class TileScheduler {
+public:
+    TileScheduler() = default;
+
+    /**
+     * @param domain domain of the simulation
+     * @param tileWidth length of an edge of a tile
+     */
+    TileScheduler(const Domain& domain, const double tileWidth);
+
+    /**
+     * @brief group the particles into tiles and assign the tiles to the threads
+     * @details Call this after the neighbor search, since the neighbor lists are used to estimate the work. The
+     * particles do not have to be in their tiles afterwards, e.g. when they have moved, since only the locality of the
+     * memory access depends on it.
+     * @param particles particles to schedule
+     * @param numThreads number of threads to assign the tiles to
+     */
+    void build(const Particles& particles, const int numThreads);
+
+    /**
+     * @brief call the function for each particle in parallel
+     * @details Each thread calls it for the particles of its own tiles first. It starts a parallel region itself, and
+     * the function must not depend on the order of the particles. Each call has its own cursors of the tiles, so calls
+     * may run at the same time, e.g. in the tasks of TaskGraph. When it is called in a parallel region, where a nested
+     * region would run on a single thread, a task is created for each thread of the region instead, and each task
+     * starts with the tiles of the thread that runs it.
+     * @param function function called with the id of each particle
+     */
+    template <typename Function> void forEach(const Function& function) const {
+        int numAssigned = static_cast<int>(threadTiles.size()) - 1;
+        if (numAssigned < 1)
+            return; // not built yet
+
+        std::vector<std::atomic<int>> cursors(numAssigned); // next tile to take of each thread
+        for (int t = 0; t < numAssigned; t++) {
+            cursors[t].store(threadTiles[t], std::memory_order_relaxed);
+        }
+
+        // the own tiles first, and then the remaining tiles of the other threads
+        auto work = [&](const int own) {
+            for (int k = 0; k < numAssigned; k++) {
+                int t = (own + k) % numAssigned;
+                for (int tile = cursors[t].fetch_add(1); tile < threadTiles[t + 1]; tile = cursors[t].fetch_add(1)) {
+                    for (int i = tileOffsets[tile]; i < tileOffsets[tile + 1]; i++) {
+                        function(order[i]);
+                    }
+                }
+            }
+        };
+
+#ifdef _OPENMP
+        if (omp_in_parallel()) {
+            int numWorkers = omp_get_num_threads();
+#pragma omp taskgroup
+            {
+                for (int worker = 0; worker < numWorkers; worker++) {
+#pragma omp task shared(work)
+                    work(omp_get_thread_num() % numAssigned);
+                }
+            }
+            return;
+        }
+#endif
+
+#pragma omp parallel
+        {
+            int own = 0;
+#ifdef _OPENMP
+            own = omp_get_thread_num() % numAssigned;
+#endif
+            work(own);
+        }
+    }
+
+    /**
+     * @brief number of particles grouped by the last build()
+     */
+    int numParticles() const;
+
+    /**
+     * @brief ids of the particles in the order of the tiles
+     */
+    const std::vector<int>& getOrder() const;
+
+    /**
+     * @brief index in getOrder() of the first particle of each occupied tile, followed by the number of particles
+     */
+    const std::vector<int>& getTileOffsets() const;
+
+    /**
+     * @brief first tile of each thread, followed by the number of occupied tiles
+     */
+    const std::vector<int>& getThreadTiles() const;
+
+private:
+    Domain domain{};
+    double tileWidth{};
+    int64_t numX = 1, numY = 1, numZ = 1; ///< number of tiles along each axis
+    std::vector<int> order;               ///< ids of the particles in the order of the tiles
+    std::vector<int> tileOffsets;         ///< first particle of each occupied tile in #order
+    std::vector<int> threadTiles;         ///< first occupied tile of each thread
+};
@@ -0,0 +1,141 @@
+#include "vtu_series.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using std::cerr;
+using std::endl;
+namespace fs = std::filesystem;
+
+VtuSeries::VtuSeries(const fs::path& path, size_t numFramesKept) {
+    this->path = path;
+
+    // frames after the kept ones are removed, e.g. the ones written after the checkpoint used for restarting
+    size_t numFrames = std::min(numFramesKept, countFrames(path));
+    uint64_t dataEnd = 0;
+    if (numFrames > 0) {
+        std::ifstream ifs(indexPath(path), std::ios::binary);
+        Frame last;
+        readRecord(ifs, numFrames - 1, last);
+        dataEnd = last.offset + last.size;
+    }
+    if (numFramesKept > numFrames) {
+        cerr << "WARNING: " << path << " has only " << numFrames << " frames of " << numFramesKept << endl;
+    }
+
+    if (numFrames == 0) {
+        index.open(indexPath(path), std::ios::binary | std::ios::trunc);
+        index.write(magic, sizeof(magic));
+        index.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        index.write(reinterpret_cast<const char*>(&byteOrderMark), sizeof(byteOrderMark));
+        data.open(path, std::ios::binary | std::ios::trunc);
+    } else {
+        fs::resize_file(indexPath(path), headerSize + numFrames * recordSize);
+        fs::resize_file(path, dataEnd);
+        index.open(indexPath(path), std::ios::binary | std::ios::app);
+        data.open(path, std::ios::binary | std::ios::app);
+    }
+    index.flush();
+    if (data.fail() || index.fail()) {
+        cerr << "cannot write " << path << endl;
+        std::exit(-1);
+    }
+    frameBegin = dataEnd;
+}
+
+std::ostream& VtuSeries::beginFrame() {
+    return data;
+}
+
+bool VtuSeries::endFrame(const double time, const size_t numParticles) {
+    data.flush();
+    if (data.fail()) {
+        cerr << "cannot write " << path << endl;
+        return false;
+    }
+    uint64_t frameEnd = static_cast<uint64_t>(data.tellp());
+
+    Frame frame;
+    frame.time         = time;
+    frame.offset       = frameBegin;
+    frame.size         = frameEnd - frameBegin;
+    frame.numParticles = numParticles;
+    index.write(reinterpret_cast<const char*>(&frame), recordSize);
+    index.flush();
+    if (index.fail()) {
+        cerr << "cannot write " << indexPath(path) << endl;
+        return false;
+    }
+    frameBegin = frameEnd;
+    return true;
+}
+
+fs::path VtuSeries::indexPath(const fs::path& path) {
+    fs::path index = path;
+    index += ".idx";
+    return index;
+}
+
+std::vector<VtuSeries::Frame> VtuSeries::readIndex(const fs::path& path) {
+    size_t numFrames = countFrames(path);
+    std::vector<Frame> frames(numFrames);
+    std::ifstream ifs(indexPath(path), std::ios::binary);
+    for (size_t i = 0; i < numFrames; i++) {
+        readRecord(ifs, i, frames[i]);
+    }
+    return frames;
+}
+
+std::string VtuSeries::readFrame(const fs::path& path, size_t frameIndex) {
+    std::ifstream ifs(indexPath(path), std::ios::binary);
+    Frame frame;
+    if (frameIndex >= countFrames(path) || !readRecord(ifs, frameIndex, frame)) {
+        cerr << "Error: frame " << frameIndex << " does not exist in " << path << endl;
+        std::exit(-1);
+    }
+
+    std::ifstream dataFile(path, std::ios::binary);
+    std::string content(frame.size, '\0');
+    dataFile.seekg(static_cast<std::streamoff>(frame.offset));
+    dataFile.read(content.data(), content.size());
+    if (dataFile.fail()) {
+        cerr << "Error: frame " << frameIndex << " is truncated in " << path << endl;
+        std::exit(-1);
+    }
+    return content;
+}
+
+size_t VtuSeries::countFrames(const fs::path& path) {
+    std::error_code error;
+    auto indexSize = fs::file_size(indexPath(path), error);
+    if (error || indexSize < headerSize || !fs::exists(path))
+        return 0;
+
+    std::ifstream ifs(indexPath(path), std::ios::binary);
+    char fileMagic[sizeof(magic)];
+    uint32_t fileVersion, fileByteOrderMark;
+    ifs.read(fileMagic, sizeof(fileMagic));
+    ifs.read(reinterpret_cast<char*>(&fileVersion), sizeof(fileVersion));
+    ifs.read(reinterpret_cast<char*>(&fileByteOrderMark), sizeof(fileByteOrderMark));
+    bool isValid = !ifs.fail() && std::memcmp(fileMagic, magic, sizeof(magic)) == 0 && fileVersion == version &&
+                   fileByteOrderMark == byteOrderMark;
+    if (!isValid)
+        return 0;
+
+    // a record partially written by a crash is ignored, and so are records of frames not in the data file
+    size_t numFrames = (indexSize - headerSize) / recordSize;
+    auto dataSize    = fs::file_size(path, error);
+    Frame frame;
+    while (numFrames > 0 && (!readRecord(ifs, numFrames - 1, frame) || frame.offset + frame.size > dataSize)) {
+        numFrames--;
+    }
+    return numFrames;
+}
+
+bool VtuSeries::readRecord(std::ifstream& index, size_t frameIndex, Frame& frame) {
+    index.clear();
+    index.seekg(static_cast<std::streamoff>(headerSize + frameIndex * recordSize));
+    index.read(reinterpret_cast<char*>(&frame), recordSize);
+    return !index.fail();
+}
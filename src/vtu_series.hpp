@@ -0,0 +1,100 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Time series of VTU frames appended to a single file
+ *
+ * @details Writing a file per output step makes tens of thousands of small files in long simulations, which is slow
+ * on parallel file systems. VtuSeries appends each frame as a complete binary VTU document to one data file
+ * (`*.vtus`) and records where it is in an index file (`*.vtus.idx`).
+ *
+ * The index file starts with a header of the magic string "MPSVTUS", the version and a byte order mark, followed by a
+ * record of fixed size per frame (#Frame). The record of frame i is at `headerSize + i * recordSize`, so any frame is
+ * found in O(1) without reading the others. A record is written only after its frame has been flushed, so the index
+ * never refers to data that has not been written.
+ */
+class VtuSeries {
+public:
+    static constexpr uint32_t version = 1; ///< version of the index format. Increment it when the format changes.
+
+    /// @brief record of a frame in the index file
+    struct Frame {
+        double time{};           ///< time of the frame
+        uint64_t offset{};       ///< offset of the VTU document in the data file in bytes
+        uint64_t size{};         ///< size of the VTU document in bytes
+        uint64_t numParticles{}; ///< number of particles in the frame
+    };
+
+    static constexpr size_t headerSize = 16;            ///< size of the header of the index file in bytes
+    static constexpr size_t recordSize = sizeof(Frame); ///< size of a record in the index file in bytes
+
+    /**
+     * @brief open a series to append frames to it
+     * @param path path to the data file. The index file is the path with the suffix ".idx".
+     * @param numFramesKept number of frames kept from an existing series, e.g. the number of output files written
+     * before the checkpoint when restarting. Later frames are removed. A new series is started if it is 0.
+     */
+    VtuSeries(const std::filesystem::path& path, size_t numFramesKept);
+
+    VtuSeries(const VtuSeries&)            = delete;
+    VtuSeries& operator=(const VtuSeries&) = delete;
+
+    /**
+     * @brief start a frame
+     * @return stream to write the VTU document of the frame to
+     */
+    std::ostream& beginFrame();
+
+    /**
+     * @brief finish the frame started by beginFrame() and add it to the index
+     * @param time time of the frame
+     * @param numParticles number of particles in the frame
+     * @return whether the frame has been written. The failure is reported to the standard error.
+     */
+    bool endFrame(const double time, const size_t numParticles);
+
+    /**
+     * @brief path to the index file of the data file
+     */
+    static std::filesystem::path indexPath(const std::filesystem::path& path);
+
+    /**
+     * @brief read the records of all the frames
+     * @param path path to the data file
+     */
+    static std::vector<Frame> readIndex(const std::filesystem::path& path);
+
+    /**
+     * @brief read the VTU document of a frame
+     * @param path path to the data file
+     * @param frameIndex index of the frame
+     */
+    static std::string readFrame(const std::filesystem::path& path, size_t frameIndex);
+
+private:
+    static constexpr char magic[8]          = "MPSVTUS";  ///< first bytes of an index file
+    static constexpr uint32_t byteOrderMark = 0x01020304; ///< used to detect files of the other byte order
+
+    std::filesystem::path path;
+    std::ofstream data;  ///< stream of the data file
+    std::ofstream index; ///< stream of the index file
+    uint64_t frameBegin; ///< offset of the frame being written in the data file
+
+    /**
+     * @brief number of valid records in the index file, or 0 if it is not a valid index file
+     */
+    static size_t countFrames(const std::filesystem::path& path);
+
+    /**
+     * @brief read the record of a frame
+     * @return false if the index file does not have the record
+     */
+    static bool readRecord(std::ifstream& index, size_t frameIndex, Frame& frame);
+};
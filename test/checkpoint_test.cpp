@@ -0,0 +1,175 @@
+#include "checkpoint.hpp"
+#include "checkpoint_writer.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class CheckpointTest : public ::testing::TestWithParam<bool> {
+protected:
+    fs::path testFilePath = "temp_file_for_checkpoint.ckpt";
+    Particles particles;
+
+    void SetUp() override {
+        std::default_random_engine engine(0);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        auto random = [&] { return Eigen::Vector3d(dist(engine), dist(engine), dist(engine)); };
+
+        for (int i = 0; i < 200; i++) {
+            auto type = static_cast<ParticleType>(i % 4);
+            particles.add(Particle(i, type, random(), random(), 1000.0 + i, i % 3));
+            Particle& p         = particles[i];
+            p.originalId        = 2 * i + 1;
+            p.acceleration      = random();
+            p.pressure          = dist(engine);
+            p.numberDensity     = dist(engine);
+            p.boundaryCondition = static_cast<FluidState>(i % 5);
+            p.sourceTerm        = dist(engine);
+            p.minimumPressure   = dist(engine);
+            for (int j = 0; j < i % 7; j++) {
+                p.neighbors.emplace_back((i + j + 1) % 200, dist(engine));
+            }
+        }
+    }
+
+    void TearDown() override {
+        fs::remove(testFilePath);
+    }
+};
+
+TEST_P(CheckpointTest, WriteAndRead) {
+    Checkpoint checkpoint;
+    checkpoint.startTime                               = 0.1;
+    checkpoint.time                                    = 1.0 / 3.0;
+    checkpoint.timeStep                                = 1234;
+    checkpoint.fileNumber                              = 56;
+    checkpoint.stepsSinceCompaction                    = 78;
+    checkpoint.neighborSearcherState.callsSinceSearch  = 3;
+    checkpoint.neighborSearcherState.isSearchRequested = false;
+    checkpoint.hasNeighbors                            = GetParam();
+    for (const auto& p : particles) {
+        checkpoint.neighborSearcherState.positionsAtSearch.push_back(p.position * 0.5);
+    }
+    ASSERT_TRUE(checkpoint.write(testFilePath, particles));
+
+    // the file written piece by piece is the same as the content serialized at once
+    std::ifstream file(testFilePath, std::ios::binary);
+    std::vector<char> written((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(written, checkpoint.serialize(particles));
+
+    auto [loaded, loadedParticles] = Checkpoint::read(testFilePath);
+    EXPECT_EQ(loaded.startTime, checkpoint.startTime);
+    EXPECT_EQ(loaded.time, checkpoint.time);
+    EXPECT_EQ(loaded.timeStep, checkpoint.timeStep);
+    EXPECT_EQ(loaded.fileNumber, checkpoint.fileNumber);
+    EXPECT_EQ(loaded.stepsSinceCompaction, checkpoint.stepsSinceCompaction);
+    EXPECT_EQ(loaded.neighborSearcherState.callsSinceSearch, 3);
+    EXPECT_FALSE(loaded.neighborSearcherState.isSearchRequested);
+    EXPECT_EQ(loaded.neighborSearcherState.positionsAtSearch, checkpoint.neighborSearcherState.positionsAtSearch);
+    EXPECT_EQ(loaded.hasNeighbors, GetParam());
+
+    // all the values have to be restored bit-exactly
+    ASSERT_EQ(loadedParticles.size(), particles.size());
+    for (int i = 0; i < particles.size(); i++) {
+        const Particle& p = particles[i];
+        const Particle& q = loadedParticles[i];
+        EXPECT_EQ(q.id, i);
+        EXPECT_EQ(q.originalId, p.originalId);
+        EXPECT_EQ(q.type, p.type);
+        EXPECT_EQ(q.fluidType, p.fluidType);
+        EXPECT_EQ(q.position, p.position);
+        EXPECT_EQ(q.velocity, p.velocity);
+        EXPECT_EQ(q.acceleration, p.acceleration);
+        EXPECT_EQ(q.pressure, p.pressure);
+        EXPECT_EQ(q.numberDensity, p.numberDensity);
+        EXPECT_EQ(q.density, p.density);
+        EXPECT_EQ(q.boundaryCondition, p.boundaryCondition);
+        EXPECT_EQ(q.sourceTerm, p.sourceTerm);
+        EXPECT_EQ(q.minimumPressure, p.minimumPressure);
+        if (GetParam()) {
+            ASSERT_EQ(q.neighbors.size(), p.neighbors.size());
+            for (size_t n = 0; n < p.neighbors.size(); n++) {
+                EXPECT_EQ(q.neighbors[n].id, p.neighbors[n].id);
+                EXPECT_EQ(q.neighbors[n].distance, p.neighbors[n].distance);
+            }
+        } else {
+            EXPECT_TRUE(q.neighbors.empty());
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(WithAndWithoutNeighbors, CheckpointTest, ::testing::Values(true, false));
+
+class CheckpointFilesTest : public ::testing::Test {
+protected:
+    fs::path directory = "temp_directory_for_checkpoint";
+    Particles particles;
+
+    void SetUp() override {
+        for (int i = 0; i < 10; i++) {
+            auto position = Eigen::Vector3d(0.1 * i, 0.0, 0.0);
+            particles.add(Particle(i, ParticleType::Fluid, position, Eigen::Vector3d::Zero(), 1000.0, 0));
+        }
+    }
+
+    void TearDown() override {
+        fs::remove_all(directory);
+    }
+};
+
+TEST_F(CheckpointFilesTest, CorruptedFileIsInvalid) {
+    fs::create_directories(directory);
+    fs::path path = directory / Checkpoint::fileName(10);
+    Checkpoint checkpoint;
+    ASSERT_TRUE(checkpoint.write(path, particles));
+    EXPECT_TRUE(Checkpoint::isValid(path));
+    EXPECT_FALSE(fs::exists(fs::path(path).concat(".tmp")));
+
+    // flip one byte of a position
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(200);
+    file.put(0x7f);
+    file.close();
+    EXPECT_FALSE(Checkpoint::isValid(path));
+
+    // truncated file
+    fs::resize_file(path, fs::file_size(path) / 2);
+    EXPECT_FALSE(Checkpoint::isValid(path));
+}
+
+TEST_F(CheckpointFilesTest, FindLatestSkipsInvalidFiles) {
+    CheckpointWriter writer(directory, 0, true);
+    Checkpoint checkpoint;
+    for (int timeStep : {10, 20, 30}) {
+        checkpoint.timeStep = timeStep;
+        writer.write(checkpoint, particles);
+    }
+    writer.finish();
+    EXPECT_EQ(Checkpoint::findLatest(directory), directory / Checkpoint::fileName(30));
+
+    // the newest file is broken, e.g. by a crash of the node
+    fs::resize_file(directory / Checkpoint::fileName(30), 100);
+    EXPECT_EQ(Checkpoint::findLatest(directory), directory / Checkpoint::fileName(20));
+    EXPECT_TRUE(fs::exists(directory / (Checkpoint::fileName(30) + ".invalid")));
+
+    EXPECT_TRUE(Checkpoint::findLatest("temp_directory_not_existing").empty());
+}
+
+TEST_F(CheckpointFilesTest, OnlyNewestFilesAreKept) {
+    CheckpointWriter writer(directory, 2, false);
+    Checkpoint checkpoint;
+    for (int timeStep : {5, 100, 15, 20}) {
+        checkpoint.timeStep = timeStep;
+        writer.write(checkpoint, particles);
+    }
+
+    auto paths = Checkpoint::list(directory);
+    ASSERT_EQ(paths.size(), 2);
+    EXPECT_EQ(paths[0], directory / Checkpoint::fileName(20));
+    EXPECT_EQ(paths[1], directory / Checkpoint::fileName(100));
+}
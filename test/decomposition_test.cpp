@@ -0,0 +1,65 @@
+#include "distributed/decomposition.hpp"
+
+#include <gtest/gtest.h>
+
+using Distributed::Decomposition;
+
+TEST(DecompositionTest, RankOfPosition) {
+    Decomposition decomposition(1, {0.0, 1.0});
+    EXPECT_EQ(decomposition.size(), 3);
+    EXPECT_EQ(decomposition.rankOf(Eigen::Vector3d(5.0, -0.5, 0.0)), 0);
+    // the positions on a boundary belong to the upper slab
+    EXPECT_EQ(decomposition.rankOf(Eigen::Vector3d(0.0, 0.0, 0.0)), 1);
+    EXPECT_EQ(decomposition.rankOf(Eigen::Vector3d(0.0, 0.5, 0.0)), 1);
+    EXPECT_EQ(decomposition.rankOf(Eigen::Vector3d(0.0, 100.0, 0.0)), 2);
+}
+
+TEST(DecompositionTest, HaloRanksWithinWidth) {
+    Decomposition decomposition(0, {0.0, 1.0, 1.2});
+    EXPECT_TRUE(decomposition.haloRanks(Eigen::Vector3d(0.5, 0.0, 0.0), 1, 0.3).empty());
+    EXPECT_EQ(decomposition.haloRanks(Eigen::Vector3d(0.1, 0.0, 0.0), 1, 0.3), std::vector<int>({0}));
+    // the halo can reach beyond a thin slab
+    EXPECT_EQ(decomposition.haloRanks(Eigen::Vector3d(0.9, 0.0, 0.0), 1, 0.4), std::vector<int>({2, 3}));
+    EXPECT_EQ(decomposition.haloRanks(Eigen::Vector3d(1.1, 0.0, 0.0), 2, 0.2), std::vector<int>({1, 3}));
+    EXPECT_TRUE(decomposition.haloRanks(Eigen::Vector3d(5.0, 0.0, 0.0), 3, 0.3).empty());
+}
+
+TEST(DecompositionTest, BalancedAlongLongestAxis) {
+    Particles particles;
+    for (int i = 0; i < 100; i++) {
+        Eigen::Vector3d position(0.01 * (i % 10), 0.1 * (i / 10), 0.0);
+        particles.add(Particle(particles.size(), ParticleType::Fluid, position, Eigen::Vector3d::Zero(), 1.0, 0));
+    }
+    // ghost particles are not counted
+    Eigen::Vector3d far(100.0, 0.0, 0.0);
+    particles.add(Particle(particles.size(), ParticleType::Ghost, far, Eigen::Vector3d::Zero(), 1.0, 0));
+
+    auto decomposition = Decomposition::balanced(particles, 4, 2);
+    EXPECT_EQ(decomposition.getAxis(), 1);
+    ASSERT_EQ(decomposition.size(), 4);
+    std::vector<int> counts(4, 0);
+    for (const auto& p : particles) {
+        if (p.type != ParticleType::Ghost)
+            counts[decomposition.rankOf(p.position)]++;
+    }
+    // rows of 10 particles cannot be split, so each slab has 20 or 30 particles
+    for (const auto& count : counts) {
+        EXPECT_GE(count, 20);
+        EXPECT_LE(count, 30);
+    }
+}
+
+TEST(DecompositionTest, FromWorkSplitsEqualWork) {
+    // the work of the first bin is the same as that of the other three bins together
+    auto decomposition = Decomposition::fromWork(2, -1.0, 0.5, {6.0, 2.0, 2.0, 2.0}, 2);
+    EXPECT_EQ(decomposition.getAxis(), 2);
+    ASSERT_EQ(decomposition.size(), 2);
+    EXPECT_DOUBLE_EQ(decomposition.getBoundaries()[0], -0.5);
+
+    // the boundaries are interpolated within the bins
+    decomposition = Decomposition::fromWork(0, 0.0, 1.0, {4.0, 4.0}, 4);
+    ASSERT_EQ(decomposition.size(), 4);
+    EXPECT_DOUBLE_EQ(decomposition.getBoundaries()[0], 0.5);
+    EXPECT_DOUBLE_EQ(decomposition.getBoundaries()[1], 1.0);
+    EXPECT_DOUBLE_EQ(decomposition.getBoundaries()[2], 1.5);
+}
@@ -0,0 +1,81 @@
+#include "domain.hpp"
+#include "neighbor_kernel.hpp"
+#include "neighbor_searcher.hpp"
+#include "weight.hpp"
+
+#include <gtest/gtest.h>
+#include <random>
+
+class NeighborKernelTest : public ::testing::Test {
+protected:
+    double re = 0.1;
+    Particles particles;
+
+    void SetUp() override {
+        size_t particleSize = 500;
+        Domain domain;
+        domain.xMin    = 0.0;
+        domain.xMax    = 0.5;
+        domain.yMin    = 0.0;
+        domain.yMax    = 0.5;
+        domain.zMin    = 0.0;
+        domain.zMax    = 0.5;
+        domain.xLength = domain.xMax - domain.xMin;
+        domain.yLength = domain.yMax - domain.yMin;
+        domain.zLength = domain.zMax - domain.zMin;
+
+        std::default_random_engine engine(0);
+        std::uniform_real_distribution<double> dist_r(0.0, 0.5);
+        std::uniform_real_distribution<double> dist_u(-1.0, 1.0);
+        std::uniform_real_distribution<double> dist_p(0.0, 1000.0);
+
+        for (size_t i = 0; i < particleSize; i++) {
+            auto r_i = Eigen::Vector3d(dist_r(engine), dist_r(engine), dist_r(engine));
+            auto u_i = Eigen::Vector3d(dist_u(engine), dist_u(engine), dist_u(engine));
+            // every 7th particle is a dummy wall particle, which must be masked in the pressure gradient
+            auto type = (i % 7 == 0) ? ParticleType::DummyWall : ParticleType::Fluid;
+            particles.add(Particle(i, type, r_i, u_i, 1000.0, 0));
+            particles[i].pressure        = dist_p(engine);
+            particles[i].minimumPressure = 0.5 * particles[i].pressure;
+        }
+
+        // search with a larger radius than re so that the kernels have to mask distant neighbors
+        NeighborSearcher searcher(1.5 * re, domain, particleSize);
+        searcher.setNeighbors(particles);
+    }
+};
+
+TEST_F(NeighborKernelTest, ViscosityMatchesBruteForce) {
+    for (const auto& pi : particles) {
+        Eigen::Vector3d expected = Eigen::Vector3d::Zero();
+        for (const auto& pj : particles) {
+            double distance = (pj.position - pi.position).norm();
+            if (pj.id != pi.id && distance < re) {
+                expected += (pj.velocity - pi.velocity) * weight(distance, re);
+            }
+        }
+        Eigen::Vector3d actual = NeighborKernel::viscosity(particles, pi, re);
+        EXPECT_LT((actual - expected).norm(), 1e-12 * (1.0 + expected.norm())) << "particle " << pi.id;
+    }
+}
+
+TEST_F(NeighborKernelTest, PressureGradientMatchesBruteForce) {
+    for (const auto& pi : particles) {
+        Eigen::Vector3d expected = Eigen::Vector3d::Zero();
+        for (const auto& pj : particles) {
+            Eigen::Vector3d r = pj.position - pi.position;
+            if (pj.id != pi.id && pj.type != ParticleType::DummyWall && r.norm() < re) {
+                expected += r * (pj.pressure - pi.minimumPressure) / r.squaredNorm() * weight(r.norm(), re);
+            }
+        }
+        Eigen::Vector3d actual = NeighborKernel::pressureGradient(particles, pi, re);
+        EXPECT_LT((actual - expected).norm(), 1e-12 * (1.0 + expected.norm())) << "particle " << pi.id;
+    }
+}
+
+TEST_F(NeighborKernelTest, NoNeighbors) {
+    Particles single;
+    single.add(Particle(0, ParticleType::Fluid, Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero(), 1000.0, 0));
+    EXPECT_EQ(NeighborKernel::viscosity(single, single[0], re), Eigen::Vector3d::Zero());
+    EXPECT_EQ(NeighborKernel::pressureGradient(single, single[0], re), Eigen::Vector3d::Zero());
+}
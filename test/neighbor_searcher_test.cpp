@@ -2,6 +2,7 @@
 #include "neighbor_searcher.hpp"
 
 #include <gtest/gtest.h>
+#include <limits>
 #include <random>
 #include <set>
 
@@ -49,3 +50,182 @@ TEST(NeighborSearcherTest, NeighborSearch2d) {
         EXPECT_EQ(neighborsByBruteForce, neighborsBySearcher);
     }
 }
+
+TEST(NeighborSearcherTest, UpdateNeighborsWithSkin) {
+    double re           = 0.1;
+    double skin         = 0.02;
+    size_t particleSize = 200;
+    Domain domain;
+    domain.xMin    = 0.0;
+    domain.xMax    = 1.0;
+    domain.yMin    = 0.0;
+    domain.yMax    = 1.0;
+    domain.zMin    = 0.0;
+    domain.zMax    = 0.0;
+    domain.xLength = domain.xMax - domain.xMin;
+    domain.yLength = domain.yMax - domain.yMin;
+    domain.zLength = domain.zMax - domain.zMin;
+
+    std::default_random_engine engine(0);
+    std::uniform_real_distribution<double> dist_r(0.1, 0.9);
+    std::uniform_real_distribution<double> dist_move(-0.002, 0.002);
+
+    auto particles = Particles();
+    for (size_t i = 0; i < particleSize; i++) {
+        auto r_i = Eigen::Vector3d(dist_r(engine), dist_r(engine), 0.0);
+        auto u_i = Eigen::Vector3d::Zero();
+        particles.add(Particle(i, ParticleType::Fluid, r_i, u_i, 1.0, 0));
+    }
+
+    NeighborSearcher searcher(re, domain, particleSize, skin, 100);
+    EXPECT_TRUE(searcher.updateNeighbors(particles)); // first call always searches
+
+    int numSearches = 0;
+    for (int step = 0; step < 20; step++) {
+        for (auto& p : particles) {
+            p.position += Eigen::Vector3d(dist_move(engine), dist_move(engine), 0.0);
+        }
+        if (searcher.updateNeighbors(particles)) {
+            numSearches++;
+        }
+
+        // neighbors within re must always be found, with up-to-date distances
+        for (const auto& pi : particles) {
+            std::set<int> neighborsByBruteForce;
+            for (const auto& pj : particles) {
+                if (pi.id != pj.id && (pi.position - pj.position).norm() < re) {
+                    neighborsByBruteForce.insert(pj.id);
+                }
+            }
+            std::set<int> neighborsBySearcher;
+            for (const auto& neighbor : pi.neighbors) {
+                EXPECT_DOUBLE_EQ(neighbor.distance, (particles[neighbor.id].position - pi.position).norm());
+                if (neighbor.distance < re) {
+                    neighborsBySearcher.insert(neighbor.id);
+                }
+            }
+            EXPECT_EQ(neighborsByBruteForce, neighborsBySearcher);
+        }
+    }
+    // particles move at most 0.04 * sqrt(2) in 20 steps, so a few searches are forced by the displacement check
+    EXPECT_GT(numSearches, 0);
+    EXPECT_LT(numSearches, 20);
+
+    searcher.requestSearch();
+    EXPECT_TRUE(searcher.updateNeighbors(particles));
+}
+
+TEST(NeighborSearcherTest, SparseBucketGivesSameNeighbors) {
+    double re           = 0.1;
+    size_t particleSize = 500;
+    // a large domain where the particles occupy a small corner
+    Domain domain;
+    domain.xMin    = -5.0;
+    domain.xMax    = 5.0;
+    domain.yMin    = -5.0;
+    domain.yMax    = 5.0;
+    domain.zMin    = -5.0;
+    domain.zMax    = 5.0;
+    domain.xLength = domain.xMax - domain.xMin;
+    domain.yLength = domain.yMax - domain.yMin;
+    domain.zLength = domain.zMax - domain.zMin;
+
+    std::default_random_engine engine(0);
+    std::uniform_real_distribution<double> dist_r(0.0, 0.5);
+
+    auto dense = Particles();
+    for (size_t i = 0; i < particleSize; i++) {
+        auto r_i = Eigen::Vector3d(dist_r(engine), dist_r(engine), dist_r(engine));
+        dense.add(Particle(i, ParticleType::Fluid, r_i, Eigen::Vector3d::Zero(), 1.0, 0));
+    }
+    // a particle out of the domain becomes a ghost particle in both buckets
+    dense[7].position.x() = 6.0;
+    auto sparse           = dense;
+
+    NeighborSearcher denseSearcher(re, domain, particleSize);
+    NeighborSearcher sparseSearcher(re, domain, particleSize, 0.0, 1, true);
+    denseSearcher.setNeighbors(dense);
+    sparseSearcher.setNeighbors(sparse);
+    // search again so that the hash table is sized for the occupied cells
+    sparseSearcher.setNeighbors(sparse);
+
+    EXPECT_EQ(dense[7].type, ParticleType::Ghost);
+    EXPECT_EQ(sparse[7].type, ParticleType::Ghost);
+    for (size_t i = 0; i < particleSize; i++) {
+        ASSERT_EQ(dense[i].neighbors.size(), sparse[i].neighbors.size());
+        for (size_t n = 0; n < dense[i].neighbors.size(); n++) {
+            EXPECT_EQ(dense[i].neighbors[n].id, sparse[i].neighbors[n].id);
+            EXPECT_EQ(dense[i].neighbors[n].distance, sparse[i].neighbors[n].distance);
+        }
+    }
+}
+
+TEST(NeighborSearcherTest, SparseBucketScalesWithOccupiedCells) {
+    double re = 0.1;
+    Domain domain;
+    domain.xMin    = 0.0;
+    domain.xMax    = 100.0;
+    domain.yMin    = 0.0;
+    domain.yMax    = 100.0;
+    domain.zMin    = 0.0;
+    domain.zMax    = 100.0;
+    domain.xLength = domain.xMax - domain.xMin;
+    domain.yLength = domain.yMax - domain.yMin;
+    domain.zLength = domain.zMax - domain.zMin;
+
+    // 10 x 10 x 10 particles, one per cell, in a domain of 10^9 cells
+    auto particles = Particles();
+    for (int i = 0; i < 1000; i++) {
+        auto r_i = Eigen::Vector3d(0.15 + 0.1 * (i % 10), 0.15 + 0.1 * (i / 10 % 10), 0.15 + 0.1 * (i / 100));
+        particles.add(Particle(i, ParticleType::Fluid, r_i, Eigen::Vector3d::Zero(), 1.0, 0));
+    }
+
+    SparseBucket bucket(re, domain, particles.size());
+    for (int call = 0; call < 2; call++) {
+        bucket.storeParticles(particles);
+        EXPECT_EQ(bucket.numOccupied(), 1000);
+        EXPECT_LE(bucket.capacity(), 4096);
+    }
+    EXPECT_EQ(bucket.getFirst(2, 2, 2), 0);
+    EXPECT_EQ(bucket.getFirst(1, 1, 1), -1);
+}
+
+TEST(NeighborSearcherTest, OutOfDomainParticlesBecomeGhosts) {
+    Domain domain;
+    domain.xMin    = 0.0;
+    domain.xMax    = 1.0;
+    domain.yMin    = 0.0;
+    domain.yMax    = 1.0;
+    domain.zMin    = 0.0;
+    domain.zMax    = 0.0;
+    domain.xLength = domain.xMax - domain.xMin;
+    domain.yLength = domain.yMax - domain.yMin;
+    domain.zLength = domain.zMax - domain.zMin;
+
+    auto particles = Particles();
+    for (int i = 0; i < 100; i++) {
+        auto r_i = Eigen::Vector3d(0.01 * i, 0.5, 0.0);
+        particles.add(Particle(i, ParticleType::Fluid, r_i, Eigen::Vector3d::Zero(), 1.0, 0));
+        particles[i].originalId = 1000 + i;
+    }
+    particles[90].position.x() = 1.5;
+    particles[30].position.y() = -0.1;
+    particles[60].position.x() = std::numeric_limits<double>::quiet_NaN();
+
+    NeighborSearcher searcher(0.1, domain, particles.size());
+    searcher.setNeighbors(particles);
+    auto escaped = searcher.takeEscapedParticles();
+    ASSERT_EQ(escaped.size(), 3);
+    EXPECT_EQ(escaped[0].id, 30);
+    EXPECT_EQ(escaped[0].originalId, 1030);
+    EXPECT_EQ(escaped[0].position, particles[30].position);
+    EXPECT_EQ(escaped[1].id, 60);
+    EXPECT_EQ(escaped[2].id, 90);
+    for (int i : {30, 60, 90}) {
+        EXPECT_EQ(particles[i].type, ParticleType::Ghost);
+    }
+
+    // ghost particles are not reported again
+    searcher.setNeighbors(particles);
+    EXPECT_TRUE(searcher.takeEscapedParticles().empty());
+}
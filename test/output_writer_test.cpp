@@ -0,0 +1,57 @@
+#include "output_writer.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class OutputWriterTest : public ::testing::TestWithParam<bool> {
+protected:
+    Particles particles;
+    fs::path dir = "output_writer_test";
+
+    void SetUp() override {
+        for (int i = 0; i < 100; i++) {
+            auto r_i = Eigen::Vector3d::Zero();
+            auto u_i = Eigen::Vector3d::Zero();
+            particles.add(Particle(i, ParticleType::Fluid, r_i, u_i, 1.0, 0));
+        }
+        fs::create_directories(dir);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+};
+
+TEST_P(OutputWriterTest, WritesSnapshotOfEachCall) {
+    constexpr int numFiles = 10;
+    {
+        OutputWriter writer(GetParam());
+        for (int n = 0; n < numFiles; n++) {
+            particles[0].position.x() = n;
+            fs::path path             = dir / ("output_" + std::to_string(n) + ".csv");
+            writer.write(particles, [=](ParticlesExporter& exporter) { return exporter.toCsv(path, n); });
+        }
+        // the particles are copied at write(), so changing them must not affect the files
+        particles[0].position.x() = -1.0;
+        writer.finish();
+    }
+
+    for (int n = 0; n < numFiles; n++) {
+        std::ifstream ifs(dir / ("output_" + std::to_string(n) + ".csv"));
+        ASSERT_FALSE(ifs.fail());
+        std::string time, size, header, firstParticle;
+        std::getline(ifs, time);
+        std::getline(ifs, size);
+        std::getline(ifs, header);
+        std::getline(ifs, firstParticle);
+        EXPECT_EQ(std::stoi(time), n);
+        EXPECT_EQ(std::stoi(size), particles.size());
+        EXPECT_EQ(firstParticle, "1,0," + std::to_string(n) + ",0,0,0,0,0");
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AsyncAndSync, OutputWriterTest, ::testing::Values(true, false));
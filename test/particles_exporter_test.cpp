@@ -1,6 +1,8 @@
 #include "particles_exporter.hpp"
 
+#include <fstream>
 #include <gtest/gtest.h>
+#include <sstream>
 
 TEST(ParticlesExporterTest, SetParticles) {
     constexpr size_t particleSize = 100;
@@ -30,9 +32,12 @@ TEST(ParticlesExporterTest, ToProf) {
     exporter.setParticles(particles);
     const std::filesystem::path path = "test.prof";
     const double time                = 0.0;
-    exporter.toProf(path, time);
+    EXPECT_TRUE(exporter.toProf(path, time));
     EXPECT_TRUE(std::filesystem::exists(path));
     std::filesystem::remove(path);
+
+    // the failure is returned instead of exiting, since the file may be written in the writer thread
+    EXPECT_FALSE(exporter.toProf("no_such_directory/test.prof", time));
 }
 TEST(ParticlesExporterTest, ToVtu) {
     constexpr size_t particleSize = 100;
@@ -52,3 +57,96 @@ TEST(ParticlesExporterTest, ToVtu) {
     EXPECT_TRUE(std::filesystem::exists(path));
     std::filesystem::remove(path);
 }
+TEST(ParticlesExporterTest, ToVtuWithFields) {
+    constexpr size_t particleSize = 100;
+
+    ParticlesExporter exporter;
+    Particles particles;
+    for (size_t i = 0; i < particleSize; i++) {
+        auto r_i = Eigen::Vector3d::Zero();
+        auto u_i = Eigen::Vector3d::Zero();
+        particles.add(Particle(i, ParticleType::Fluid, r_i, u_i, 1.0, 0));
+    }
+
+    exporter.setParticles(particles);
+    exporter.setFields({ParticleField::Pressure});
+    const std::filesystem::path path = "test_fields.vtu";
+    exporter.toVtu(path, 0.0);
+
+    std::ifstream ifs(path);
+    std::stringstream content;
+    content << ifs.rdbuf();
+    ifs.close();
+    EXPECT_NE(content.str().find("Name=\"Position\""), std::string::npos);
+    EXPECT_NE(content.str().find("Name=\"Pressure\""), std::string::npos);
+    EXPECT_EQ(content.str().find("Name=\"Velocity\""), std::string::npos);
+    EXPECT_EQ(content.str().find("Name=\"Particle Type\""), std::string::npos);
+    std::filesystem::remove(path);
+}
+TEST(ParticlesExporterTest, ToVtuWithoutCells) {
+    constexpr size_t particleSize = 100;
+
+    ParticlesExporter exporter;
+    Particles particles;
+    for (size_t i = 0; i < particleSize; i++) {
+        auto r_i = Eigen::Vector3d::Zero();
+        auto u_i = Eigen::Vector3d::Zero();
+        particles.add(Particle(i, ParticleType::Fluid, r_i, u_i, 1.0, 0));
+    }
+
+    auto read = [](const std::filesystem::path& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        std::stringstream content;
+        content << ifs.rdbuf();
+        return content.str();
+    };
+
+    exporter.setParticles(particles);
+    const std::filesystem::path path = "test_cells.vtu";
+    for (bool binary : {false, true}) {
+        exporter.setWritesCells(true);
+        exporter.toVtu(path, 0.0, 1.0, binary);
+        std::string withCells = read(path);
+        EXPECT_NE(withCells.find("NumberOfCells=\"100\""), std::string::npos);
+        EXPECT_NE(withCells.find("type=\"Int32\" Name=\"connectivity\""), std::string::npos);
+
+        exporter.setWritesCells(false);
+        exporter.toVtu(path, 0.0, 1.0, binary);
+        std::string withoutCells = read(path);
+        EXPECT_NE(withoutCells.find("NumberOfCells=\"0\""), std::string::npos);
+        EXPECT_EQ(withoutCells.find("<Cells>"), std::string::npos);
+        EXPECT_LT(withoutCells.size(), withCells.size());
+    }
+    std::filesystem::remove(path);
+}
+TEST(ParticlesExporterTest, SnapshotAndParticlesGiveSameFile) {
+    constexpr size_t particleSize = 100;
+
+    Particles particles;
+    for (size_t i = 0; i < particleSize; i++) {
+        auto r_i = Eigen::Vector3d(i, 2.0 * i, 3.0 * i);
+        auto u_i = Eigen::Vector3d(-1.0 * i, 0.5, 0.0);
+        particles.add(Particle(i, ParticleType::Fluid, r_i, u_i, 1.0, i % 2));
+        particles[i].pressure = 10.0 * i;
+    }
+    ParticlesSnapshot snapshot;
+    snapshot.capture(particles);
+
+    auto read = [](const std::filesystem::path& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        std::stringstream content;
+        content << ifs.rdbuf();
+        return content.str();
+    };
+
+    ParticlesExporter exporter;
+    for (bool binary : {false, true}) {
+        exporter.setParticles(particles);
+        exporter.toVtu("test_particles.vtu", 1.0, 1.0, binary);
+        exporter.setParticles(ParticlesView(snapshot));
+        exporter.toVtu("test_snapshot.vtu", 1.0, 1.0, binary);
+        EXPECT_EQ(read("test_particles.vtu"), read("test_snapshot.vtu"));
+    }
+    std::filesystem::remove("test_particles.vtu");
+    std::filesystem::remove("test_snapshot.vtu");
+}
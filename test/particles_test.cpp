@@ -0,0 +1,32 @@
+#include "particles.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(ParticlesTest, RemoveGhosts) {
+    constexpr size_t particleSize = 10;
+
+    Particles particles;
+    for (size_t i = 0; i < particleSize; i++) {
+        auto r_i  = Eigen::Vector3d(i, 0.0, 0.0);
+        auto u_i  = Eigen::Vector3d::Zero();
+        auto type = (i % 3 == 0) ? ParticleType::Ghost : ParticleType::Fluid;
+        particles.add(Particle(i, type, r_i, u_i, 1.0, 0));
+        particles[i].neighbors.emplace_back(0, 1.0);
+    }
+
+    EXPECT_EQ(particles.removeGhosts(), 4); // 0, 3, 6, 9
+    ASSERT_EQ(particles.size(), 6);
+
+    std::vector<int> expectedOriginalIds = {1, 2, 4, 5, 7, 8};
+    for (int i = 0; i < particles.size(); i++) {
+        EXPECT_EQ(particles[i].id, i);
+        EXPECT_EQ(particles[i].originalId, expectedOriginalIds[i]);
+        EXPECT_EQ(particles[i].position.x(), expectedOriginalIds[i]);
+        EXPECT_NE(particles[i].type, ParticleType::Ghost);
+        EXPECT_TRUE(particles[i].neighbors.empty());
+    }
+
+    // nothing to remove
+    EXPECT_EQ(particles.removeGhosts(), 0);
+    EXPECT_EQ(particles.size(), 6);
+}
@@ -0,0 +1,47 @@
+#include "performance_report.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(PerformanceReportTest, PercentilesByNearestRank) {
+    std::vector<double> values;
+    for (int i = 100; i >= 1; i--) {
+        values.push_back(i);
+    }
+    auto s = PerformanceReport::calcStatistics(values);
+    EXPECT_DOUBLE_EQ(s.total, 5050.0);
+    EXPECT_DOUBLE_EQ(s.mean, 50.5);
+    EXPECT_DOUBLE_EQ(s.min, 1.0);
+    EXPECT_DOUBLE_EQ(s.p50, 50.0);
+    EXPECT_DOUBLE_EQ(s.p90, 90.0);
+    EXPECT_DOUBLE_EQ(s.p99, 99.0);
+    EXPECT_DOUBLE_EQ(s.max, 100.0);
+
+    auto single = PerformanceReport::calcStatistics({3.0});
+    EXPECT_DOUBLE_EQ(single.p50, 3.0);
+    EXPECT_DOUBLE_EQ(single.p99, 3.0);
+
+    auto empty = PerformanceReport::calcStatistics({});
+    EXPECT_DOUBLE_EQ(empty.mean, 0.0);
+    EXPECT_DOUBLE_EQ(empty.max, 0.0);
+}
+
+TEST(PerformanceReportTest, ThroughputAndStages) {
+    PerformanceReport report;
+    report.addStep(0.5, 1000, 10);
+    report.addStep(1.5, 1000, 30);
+    report.setStageSeconds({{StepStage::SearchNeighbors, 1.0}, {StepStage::Pressure, 0.5}});
+
+    EXPECT_EQ(report.numSteps(), 2);
+    EXPECT_DOUBLE_EQ(report.particleUpdatesPerSecond(), 1000.0);
+    EXPECT_DOUBLE_EQ(report.solverIterations().mean, 20.0);
+    EXPECT_DOUBLE_EQ(report.solverIterations().max, 30.0);
+
+    // the seconds per step of each stage and the rest of the time steps
+    auto json = report.toJson();
+    EXPECT_NE(
+        json.find("\"stageSecondsPerStep\": {\"SearchNeighbors\": 0.5, \"Pressure\": 0.25, \"Other\": 0.25}"),
+        std::string::npos
+    );
+    EXPECT_NE(json.find("\"particleUpdatesPerSecond\": 1000,"), std::string::npos);
+    EXPECT_NE(report.toTable().find("SearchNeighbors"), std::string::npos);
+}
@@ -0,0 +1,67 @@
+#include "step_stage.hpp"
+#include "task_graph.hpp"
+#include "task_trace.hpp"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(TaskGraphTest, TasksRunAfterDependencies) {
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto task = [&](const std::string& name) {
+        return [&, name] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    };
+
+    // a diamond: b and c run at the same time after a, and d after both of them
+    TaskGraph graph;
+    int a = graph.add("a", task("a"));
+    int b = graph.add("b", task("b"), {a});
+    int c = graph.add("c", task("c"), {a});
+    graph.add("d", task("d"), {b, c});
+    EXPECT_EQ(graph.size(), 4);
+
+    TaskTrace trace;
+    graph.run(&trace);
+    ASSERT_EQ(order.size(), 4);
+    EXPECT_EQ(order.front(), "a");
+    EXPECT_EQ(order.back(), "d");
+    EXPECT_GE(graph.getSeconds(a), 0.0);
+    EXPECT_EQ(trace.size(), 4);
+    EXPECT_NE(trace.toJson().find("\"name\": \"d\", \"ph\": \"X\""), std::string::npos);
+}
+
+TEST(TaskGraphTest, TasksRunAloneDoNotOverlap) {
+    auto sleep = [] { std::this_thread::sleep_for(std::chrono::milliseconds(10)); };
+
+    // the task that runs alone does not overlap the other tasks of its round, so the graph waits for all of it
+    TaskGraph graph;
+    graph.add("a", sleep);
+    graph.add("b", sleep);
+    int c = graph.add("c", sleep, {}, true);
+    graph.run();
+    EXPECT_GT(graph.getSeconds(c), 0.0);
+    EXPECT_DOUBLE_EQ(graph.getExclusiveSeconds(c), graph.getSeconds(c));
+}
+
+TEST(TaskGraphTest, StagesWaitForConflictingStages) {
+    // Courant only reads the velocity, so it does not conflict with the output that reads the particles
+    auto courant = stepStageAccess(StepStage::Courant);
+    StageAccess output{{ParticleData::Position, ParticleData::Velocity, ParticleData::Pressure}, {}};
+    EXPECT_FALSE(stepStageDependsOn(output, courant));
+    EXPECT_TRUE(stepStageDependsOn(courant, stepStageAccess(StepStage::MoveParticleUsingPressureGradient)));
+    EXPECT_FALSE(stepStageDependsOn(courant, stepStageAccess(StepStage::Pressure)));
+
+    // the stages that add to the acceleration run one after another
+    EXPECT_TRUE(stepStageDependsOn(stepStageAccess(StepStage::Viscosity), stepStageAccess(StepStage::Gravity)));
+
+    // the stages with parallel loops of their own run alone
+    EXPECT_TRUE(stepStageRunsAlone(StepStage::Pressure));
+    EXPECT_FALSE(stepStageRunsAlone(StepStage::UpdateNumberDensity));
+}
@@ -0,0 +1,112 @@
+#include "../src/particles_exporter.hpp"
+#include "../src/particles_loader/csv.hpp"
+#include "../src/particles_loader/prof.hpp"
+#include "../src/particles_loader/text_parser.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+TEST(TextParserTest, ParseNumbers) {
+    std::string text = " 1 -2.5,3e-2\n+4\t\r\n-0 1.7976931348623157e308 ";
+    std::vector<double> values;
+    ASSERT_TRUE(ParticlesLoader::TextParser::parseNumbers(text.data(), text.data() + text.size(), values));
+    std::vector<double> expected = {1, -2.5, 3e-2, 4, -0.0, 1.7976931348623157e308};
+    EXPECT_EQ(values, expected);
+}
+
+TEST(TextParserTest, ParseNumbersAcrossChunks) {
+    // long enough for the text to be split into several chunks
+    std::string text;
+    std::vector<double> expected;
+    for (int i = 0; text.size() < 3 * ParticlesLoader::TextParser::chunkSize; i++) {
+        expected.push_back(i * 0.125);
+        text += std::to_string(i * 0.125) + (i % 7 == 0 ? "\n" : " ");
+    }
+    std::vector<double> values;
+    ASSERT_TRUE(ParticlesLoader::TextParser::parseNumbers(text.data(), text.data() + text.size(), values));
+    EXPECT_EQ(values, expected);
+}
+
+TEST(TextParserTest, RejectInvalidToken) {
+    std::string text = "1 2 three 4";
+    std::vector<double> values;
+    EXPECT_FALSE(ParticlesLoader::TextParser::parseNumbers(text.data(), text.data() + text.size(), values));
+    text = "1 2.0.0";
+    EXPECT_FALSE(ParticlesLoader::TextParser::parseNumbers(text.data(), text.data() + text.size(), values));
+}
+
+class TextLoaderTest : public ::testing::Test {
+protected:
+    Particles particles;
+    fs::path profPath = "temp_file_for_text_loader.prof";
+    fs::path csvPath  = "temp_file_for_text_loader.csv";
+
+    void SetUp() override {
+        // values that are written exactly in the text files
+        for (int i = 0; i < 100; i++) {
+            auto r_i  = Eigen::Vector3d(0.125 * i, 0.25 * i, -0.5 * i);
+            auto u_i  = Eigen::Vector3d(0.5 * i, 2.0, 3.0);
+            auto type = (i % 3 == 0) ? ParticleType::Wall : ParticleType::Fluid;
+            particles.add(Particle(i, type, r_i, u_i, 1000.0, i % 2));
+        }
+    }
+
+    void TearDown() override {
+        fs::remove(profPath);
+        fs::remove(csvPath);
+    }
+};
+
+TEST_F(TextLoaderTest, Prof) {
+    ParticlesExporter exporter;
+    exporter.setParticles(particles);
+    exporter.toProf(profPath, 1.5);
+
+    ParticlesLoader::Prof loader;
+    auto [startTime, loadedParticles] = loader.load(profPath, 1000.0);
+    EXPECT_DOUBLE_EQ(startTime, 1.5);
+    ASSERT_EQ(loadedParticles.size(), particles.size());
+    for (int i = 0; i < particles.size(); i++) {
+        EXPECT_EQ(loadedParticles[i].type, particles[i].type);
+        EXPECT_EQ(loadedParticles[i].position, particles[i].position);
+        EXPECT_EQ(loadedParticles[i].velocity, particles[i].velocity);
+    }
+}
+
+TEST_F(TextLoaderTest, Csv) {
+    ParticlesExporter exporter;
+    exporter.setParticles(particles);
+    exporter.toCsv(csvPath, 1.5);
+
+    ParticlesLoader::Csv loader;
+    auto [startTime, loadedParticles] = loader.load(csvPath, 500.0);
+    EXPECT_DOUBLE_EQ(startTime, 1.5);
+    ASSERT_EQ(loadedParticles.size(), particles.size());
+    for (int i = 0; i < particles.size(); i++) {
+        EXPECT_EQ(loadedParticles[i].type, particles[i].type);
+        EXPECT_EQ(loadedParticles[i].fluidType, particles[i].fluidType);
+        EXPECT_EQ(loadedParticles[i].position, particles[i].position);
+        EXPECT_EQ(loadedParticles[i].velocity, particles[i].velocity);
+    }
+}
+
+TEST_F(TextLoaderTest, CsvWithMissingColumns) {
+    std::ofstream ofs(csvPath);
+    ofs << "0.5\n2\nx, y, z, type\n1.0, 2.0, 3.0, 1\n4.0, 5.0, 6.0, 2\n";
+    ofs.close();
+
+    ParticlesLoader::Csv loader;
+    auto [startTime, loadedParticles] = loader.load(csvPath, 500.0);
+    EXPECT_DOUBLE_EQ(startTime, 0.5);
+    ASSERT_EQ(loadedParticles.size(), 2);
+    EXPECT_EQ(loadedParticles[1].type, ParticleType::Wall);
+    EXPECT_EQ(loadedParticles[1].position, Eigen::Vector3d(4.0, 5.0, 6.0));
+    EXPECT_EQ(loadedParticles[1].velocity, Eigen::Vector3d::Zero());
+    EXPECT_EQ(loadedParticles[1].fluidType, 0);
+    EXPECT_DOUBLE_EQ(loadedParticles[1].density, 500.0);
+}
@@ -0,0 +1,123 @@
+#include "domain.hpp"
+#include "tile_scheduler.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(TileSchedulerTest, EachParticleOnceInTiles) {
+    Domain domain;
+    domain.xMin    = 0.0;
+    domain.xMax    = 1.0;
+    domain.yMin    = 0.0;
+    domain.yMax    = 1.0;
+    domain.zMin    = 0.0;
+    domain.zMax    = 0.0;
+    domain.xLength = domain.xMax - domain.xMin;
+    domain.yLength = domain.yMax - domain.yMin;
+    domain.zLength = domain.zMax - domain.zMin;
+
+    // 20 x 20 particles in 4 x 4 tiles, and a ghost particle out of the domain
+    Particles particles;
+    for (int i = 0; i < 400; i++) {
+        Eigen::Vector3d position(0.05 * (i % 20) + 0.025, 0.05 * (i / 20) + 0.025, 0.0);
+        particles.add(Particle(particles.size(), ParticleType::Fluid, position, Eigen::Vector3d::Zero(), 1.0, 0));
+    }
+    Eigen::Vector3d outside(-1.0, 2.0, 0.0);
+    particles.add(Particle(particles.size(), ParticleType::Ghost, outside, Eigen::Vector3d::Zero(), 1.0, 0));
+
+    TileScheduler scheduler(domain, 0.25);
+    scheduler.build(particles, 3);
+    EXPECT_EQ(scheduler.numParticles(), particles.size());
+
+    // the particles of a tile are in the same square of the tile width
+    const auto& order   = scheduler.getOrder();
+    const auto& offsets = scheduler.getTileOffsets();
+    ASSERT_EQ(offsets.size(), 17);
+    for (int tile = 0; tile < 16; tile++) {
+        if (offsets[tile] == offsets[tile + 1])
+            continue;
+        const auto& first = particles[order[offsets[tile]]].position;
+        for (int i = offsets[tile]; i < offsets[tile + 1]; i++) {
+            const auto& p = particles[order[i]];
+            if (p.type == ParticleType::Ghost)
+                continue;
+            EXPECT_EQ(int(p.position.x() / 0.25), int(first.x() / 0.25));
+            EXPECT_EQ(int(p.position.y() / 0.25), int(first.y() / 0.25));
+        }
+    }
+
+    // the tiles are divided among the threads in order
+    const auto& threadTiles = scheduler.getThreadTiles();
+    ASSERT_EQ(threadTiles.size(), 4);
+    EXPECT_EQ(threadTiles.front(), 0);
+    EXPECT_EQ(threadTiles.back(), 16);
+    for (int t = 0; t < 3; t++) {
+        EXPECT_LE(threadTiles[t], threadTiles[t + 1]);
+    }
+
+    // every particle is visited once, even if there are fewer threads than the tiles were assigned to
+    std::vector<int> visits(particles.size(), 0);
+    scheduler.forEach([&](const int id) { visits[id]++; });
+    for (const auto& count : visits) {
+        EXPECT_EQ(count, 1);
+    }
+
+    // calls at the same time do not share the tiles left to take
+    std::vector<std::atomic<int>> concurrentVisits(particles.size());
+    auto visit = [&] { scheduler.forEach([&](const int id) { concurrentVisits[id]++; }); };
+    std::thread first(visit), second(visit);
+    first.join();
+    second.join();
+    for (const auto& count : concurrentVisits) {
+        EXPECT_EQ(count.load(), 2);
+    }
+
+    // in a parallel region, e.g. in a task of TaskGraph, a task is created for each of its threads
+    std::vector<std::atomic<int>> taskVisits(particles.size());
+#pragma omp parallel
+#pragma omp single
+    scheduler.forEach([&](const int id) { taskVisits[id]++; });
+    for (const auto& count : taskVisits) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(TileSchedulerTest, OnlyOccupiedTilesInLargeDomain) {
+    Domain domain;
+    domain.xMin    = 0.0;
+    domain.xMax    = 1000.0;
+    domain.yMin    = 0.0;
+    domain.yMax    = 1000.0;
+    domain.zMin    = 0.0;
+    domain.zMax    = 1000.0;
+    domain.xLength = domain.xMax - domain.xMin;
+    domain.yLength = domain.yMax - domain.yMin;
+    domain.zLength = domain.zMax - domain.zMin;
+
+    // 10^18 tiles in the domain, of which only the two corners are occupied
+    Particles particles;
+    for (int i = 0; i < 8; i++) {
+        Eigen::Vector3d position = Eigen::Vector3d::Constant(i < 4 ? 0.0005 : 999.9995);
+        particles.add(Particle(particles.size(), ParticleType::Fluid, position, Eigen::Vector3d::Zero(), 1.0, 0));
+    }
+
+    TileScheduler scheduler(domain, 0.001);
+    scheduler.build(particles, 2);
+    EXPECT_EQ(scheduler.numParticles(), particles.size());
+    EXPECT_EQ(scheduler.getTileOffsets(), std::vector<int>({0, 4, 8}));
+    EXPECT_EQ(scheduler.getThreadTiles(), std::vector<int>({0, 1, 2}));
+
+    std::vector<int> visits(particles.size(), 0);
+    scheduler.forEach([&](const int id) { visits[id]++; });
+    for (const auto& count : visits) {
+        EXPECT_EQ(count, 1);
+    }
+
+    // no particles, no tiles
+    scheduler.build(Particles(), 2);
+    EXPECT_EQ(scheduler.numParticles(), 0);
+    EXPECT_EQ(scheduler.getTileOffsets(), std::vector<int>({0}));
+    scheduler.forEach([&](const int) { ADD_FAILURE(); });
+}
@@ -3,8 +3,11 @@
 #include "../src/particles_exporter.hpp"
 #include "../src/particles_loader/vtu.hpp"
 
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <zlib.h>
 
 namespace fs = std::filesystem;
 
@@ -59,3 +62,169 @@ TEST_F(VtuTest, LoadValidVtuFile) {
     EXPECT_EQ(particle2.position, Eigen::Vector3d(1.0, 1.0, 1.0));
     EXPECT_EQ(particle2.velocity, Eigen::Vector3d(0.2, 0.2, 0.2));
 }
+
+class BinaryVtuTest : public ::testing::TestWithParam<bool> {
+protected:
+    fs::path testFilePath = "temp_file_for_binary_vtu_loader.vtu";
+
+    void TearDown() override {
+        fs::remove(testFilePath);
+    }
+};
+
+TEST_P(BinaryVtuTest, LoadBinaryVtuFile) {
+    // enough particles for the compressed data to be split into several blocks
+    constexpr int particleSize = 5000;
+    Particles particles;
+    for (int i = 0; i < particleSize; i++) {
+        auto r_i  = Eigen::Vector3d(0.1 * i, 0.2 * i, -0.3 * i);
+        auto u_i  = Eigen::Vector3d(1.0 / (i + 1), 2.0, 3.0);
+        auto type = (i % 3 == 0) ? ParticleType::Wall : ParticleType::Fluid;
+        particles.add(Particle(i, type, r_i, u_i, 1000.0, i % 2));
+    }
+
+    bool compressed = GetParam();
+    ParticlesExporter exporter;
+    exporter.setParticles(particles);
+    exporter.toVtu(testFilePath, 1.5, 1.0, true, compressed);
+
+    ParticlesLoader::Vtu vtuLoader;
+    auto [startTime, loadedParticles] = vtuLoader.load(testFilePath, 1000.0);
+
+    EXPECT_DOUBLE_EQ(startTime, 1.5);
+    ASSERT_EQ(loadedParticles.size(), particleSize);
+    for (int i = 0; i < particleSize; i++) {
+        EXPECT_EQ(loadedParticles[i].id, i);
+        EXPECT_EQ(loadedParticles[i].type, particles[i].type);
+        EXPECT_EQ(loadedParticles[i].fluidType, particles[i].fluidType);
+        EXPECT_EQ(loadedParticles[i].position, particles[i].position);
+        EXPECT_EQ(loadedParticles[i].velocity, particles[i].velocity);
+        EXPECT_DOUBLE_EQ(loadedParticles[i].density, 1000.0);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(RawAndZLib, BinaryVtuTest, ::testing::Values(false, true));
+
+// layouts of base64 data written by VTK and other writers
+enum class Base64Layout {
+    Appended,           ///< appended data, header and data encoded separately
+    Inline,             ///< inline data of binary format, header and data encoded together
+    AppendedCompressed, ///< appended data compressed by zlib
+};
+
+class Base64VtuTest : public ::testing::TestWithParam<Base64Layout> {
+protected:
+    fs::path testFilePath = "temp_file_for_base64_vtu_loader.vtu";
+
+    void TearDown() override {
+        fs::remove(testFilePath);
+    }
+
+    static std::string encode(const std::string& bytes) {
+        const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string text;
+        for (size_t i = 0; i < bytes.size(); i += 3) {
+            uint32_t group = static_cast<uint8_t>(bytes[i]) << 16;
+            if (i + 1 < bytes.size())
+                group |= static_cast<uint8_t>(bytes[i + 1]) << 8;
+            if (i + 2 < bytes.size())
+                group |= static_cast<uint8_t>(bytes[i + 2]);
+            text += alphabet[(group >> 18) & 63];
+            text += alphabet[(group >> 12) & 63];
+            text += (i + 1 < bytes.size()) ? alphabet[(group >> 6) & 63] : '=';
+            text += (i + 2 < bytes.size()) ? alphabet[group & 63] : '=';
+        }
+        return text;
+    }
+
+    template <typename T> static std::string toBytes(const std::vector<T>& values) {
+        return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    // base64 text of a data array with UInt64 header
+    static std::string encodeArray(const std::string& data, Base64Layout layout) {
+        uint64_t size = data.size();
+        std::string header(reinterpret_cast<const char*>(&size), sizeof(size));
+        if (layout == Base64Layout::Inline)
+            return encode(header + data);
+        if (layout == Base64Layout::Appended)
+            return encode(header) + encode(data);
+
+        // a single zlib block
+        uLongf compressedSize = compressBound(data.size());
+        std::string compressed(compressedSize, '\0');
+        compress(
+            reinterpret_cast<Bytef*>(compressed.data()),
+            &compressedSize,
+            reinterpret_cast<const Bytef*>(data.data()),
+            data.size()
+        );
+        compressed.resize(compressedSize);
+        std::vector<uint64_t> blockHeader = {1, data.size(), data.size(), compressedSize};
+        return encode(toBytes(blockHeader)) + encode(compressed);
+    }
+};
+
+TEST_P(Base64VtuTest, LoadBase64VtuFile) {
+    constexpr int particleSize = 1000;
+    std::vector<double> time   = {2.5};
+    std::vector<double> positions, velocities;
+    std::vector<int32_t> types;
+    for (int i = 0; i < particleSize; i++) {
+        positions.insert(positions.end(), {0.1 * i, 0.2 * i, -0.3 * i});
+        velocities.insert(velocities.end(), {1.0 / (i + 1), 2.0, 3.0});
+        types.push_back(i % 3 == 0 ? static_cast<int32_t>(ParticleType::Wall) : 0);
+    }
+    std::vector<std::pair<std::string, std::string>> arrays = {
+        {R"(type="Float64" Name="Time" NumberOfTuples="1")", toBytes(time)},
+        {R"(type="Float64" Name="Position" NumberOfComponents="3")", toBytes(positions)},
+        {R"(type="Float64" Name="Velocity" NumberOfComponents="3")", toBytes(velocities)},
+        {R"(type="Int32" Name="Particle Type")", toBytes(types)},
+    };
+
+    Base64Layout layout = GetParam();
+    bool isInline       = (layout == Base64Layout::Inline);
+    uint32_t one        = 1;
+    bool isLittleEndian = (*reinterpret_cast<uint8_t*>(&one) == 1);
+    std::ofstream ofs(testFilePath);
+    ofs << R"(<VTKFile type="UnstructuredGrid" version="1.0" byte_order=")"
+        << (isLittleEndian ? "LittleEndian" : "BigEndian") << R"(" header_type="UInt64")";
+    if (layout == Base64Layout::AppendedCompressed)
+        ofs << R"( compressor="vtkZLibDataCompressor")";
+    ofs << ">\n<UnstructuredGrid>\n<Piece NumberOfPoints=\"" << particleSize << "\" NumberOfCells=\"0\">\n";
+    std::string appended;
+    for (const auto& [attributes, data] : arrays) {
+        std::string text = encodeArray(data, layout);
+        if (isInline) {
+            ofs << "<DataArray " << attributes << " format=\"binary\">\n" << text << "\n</DataArray>\n";
+        } else {
+            ofs << "<DataArray " << attributes << " format=\"appended\" offset=\"" << appended.size() << "\"/>\n";
+            appended += text;
+        }
+    }
+    ofs << "</Piece>\n</UnstructuredGrid>\n";
+    if (!isInline)
+        ofs << "<AppendedData encoding=\"base64\">\n_" << appended << "\n</AppendedData>\n";
+    ofs << "</VTKFile>\n";
+    ofs.close();
+
+    ParticlesLoader::Vtu vtuLoader;
+    auto [startTime, loadedParticles] = vtuLoader.load(testFilePath, 1000.0);
+
+    EXPECT_DOUBLE_EQ(startTime, 2.5);
+    ASSERT_EQ(loadedParticles.size(), particleSize);
+    for (int i = 0; i < particleSize; i++) {
+        Eigen::Vector3d r_i(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+        Eigen::Vector3d u_i(velocities[3 * i], velocities[3 * i + 1], velocities[3 * i + 2]);
+        EXPECT_EQ(static_cast<int>(loadedParticles[i].type), types[i]);
+        EXPECT_EQ(loadedParticles[i].position, r_i);
+        EXPECT_EQ(loadedParticles[i].velocity, u_i);
+        EXPECT_DOUBLE_EQ(loadedParticles[i].density, 1000.0);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Layouts,
+    Base64VtuTest,
+    ::testing::Values(Base64Layout::Appended, Base64Layout::Inline, Base64Layout::AppendedCompressed)
+);
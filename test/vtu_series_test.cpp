@@ -0,0 +1,111 @@
+#include "particles_exporter.hpp"
+#include "particles_loader/vtu.hpp"
+#include "vtu_series.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class VtuSeriesTest : public ::testing::TestWithParam<bool> {
+protected:
+    fs::path seriesPath = "temp_file_for_series.vtus";
+    fs::path framePath  = "temp_file_for_series_frame.vtu";
+
+    /// particles of the frame. The number of particles and the positions differ among frames.
+    Particles particles(int frame) {
+        Particles ps;
+        for (int i = 0; i < 10 + frame; i++) {
+            auto position = Eigen::Vector3d(0.25 * i, 0.5 * frame, 0.0);
+            ps.add(Particle(i, ParticleType::Fluid, position, Eigen::Vector3d::Zero(), 1000.0, 0));
+        }
+        return ps;
+    }
+
+    void writeFrames(VtuSeries& series, int begin, int end) {
+        ParticlesExporter exporter;
+        for (int frame = begin; frame < end; frame++) {
+            Particles ps = particles(frame);
+            exporter.setParticles(ps);
+            exporter.toVtuSeries(series, 0.5 * frame, 1.0, GetParam());
+        }
+    }
+
+    /// check that the frame is a VTU file of the particles of the frame
+    void expectFrame(size_t frameIndex, int frame) {
+        std::string content = VtuSeries::readFrame(seriesPath, frameIndex);
+        std::ofstream(framePath, std::ios::binary).write(content.data(), content.size());
+
+        ParticlesLoader::Vtu loader;
+        auto [time, loaded] = loader.load(framePath, 1000.0);
+        Particles expected  = particles(frame);
+        EXPECT_EQ(time, 0.5 * frame);
+        ASSERT_EQ(loaded.size(), expected.size());
+        for (int i = 0; i < expected.size(); i++) {
+            EXPECT_EQ(loaded[i].position, expected[i].position);
+        }
+    }
+
+    void TearDown() override {
+        fs::remove(seriesPath);
+        fs::remove(VtuSeries::indexPath(seriesPath));
+        fs::remove(framePath);
+    }
+};
+
+TEST_P(VtuSeriesTest, WriteAndReadFrames) {
+    {
+        VtuSeries series(seriesPath, 0);
+        writeFrames(series, 0, 3);
+    }
+    EXPECT_EQ(fs::file_size(VtuSeries::indexPath(seriesPath)), VtuSeries::headerSize + 3 * VtuSeries::recordSize);
+
+    auto frames = VtuSeries::readIndex(seriesPath);
+    ASSERT_EQ(frames.size(), 3);
+    EXPECT_EQ(frames[0].offset, 0);
+    for (size_t i = 0; i < frames.size(); i++) {
+        EXPECT_EQ(frames[i].time, 0.5 * i);
+        EXPECT_EQ(frames[i].numParticles, 10 + i);
+        if (i > 0) {
+            EXPECT_EQ(frames[i].offset, frames[i - 1].offset + frames[i - 1].size);
+        }
+    }
+    EXPECT_EQ(fs::file_size(seriesPath), frames[2].offset + frames[2].size);
+
+    // frames are read in any order
+    expectFrame(2, 2);
+    expectFrame(0, 0);
+    expectFrame(1, 1);
+}
+
+TEST_P(VtuSeriesTest, FramesAfterRestartAreReplaced) {
+    {
+        VtuSeries series(seriesPath, 0);
+        writeFrames(series, 0, 4);
+    }
+    // restart after the second frame, e.g. from a checkpoint written then
+    {
+        VtuSeries series(seriesPath, 2);
+        writeFrames(series, 5, 6);
+    }
+
+    auto frames = VtuSeries::readIndex(seriesPath);
+    ASSERT_EQ(frames.size(), 3);
+    EXPECT_EQ(frames[2].time, 2.5);
+    EXPECT_EQ(fs::file_size(seriesPath), frames[2].offset + frames[2].size);
+    expectFrame(1, 1);
+    expectFrame(2, 5);
+}
+
+TEST_P(VtuSeriesTest, PartialRecordIsIgnored) {
+    {
+        VtuSeries series(seriesPath, 0);
+        writeFrames(series, 0, 2);
+    }
+    // a record partially written by a crash
+    std::ofstream(VtuSeries::indexPath(seriesPath), std::ios::binary | std::ios::app).write("abc", 3);
+    EXPECT_EQ(VtuSeries::readIndex(seriesPath).size(), 2);
+}
+
+INSTANTIATE_TEST_SUITE_P(RawAndZLib, VtuSeriesTest, ::testing::Values(false, true));